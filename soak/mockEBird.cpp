@@ -0,0 +1,340 @@
+// File:  mockEBird.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Stand-in for the eBird API (and a webhook receiving notifications) with randomized
+//        responses:  repeat and duplicate reports, revised records, large bursts, rate
+//        limiting, server and API errors and malformed payloads.
+
+// Local headers
+#include "mockEBird.h"
+
+// Standard C++ headers
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace
+{
+
+struct Species
+{
+	const char* code;
+	const char* commonName;
+	const char* scientificName;
+};
+
+const Species species[] = {
+	{ "rosgoo", "Ross's Goose", "Anser rossii" },
+	{ "eurwig", "Eurasian Wigeon", "Mareca penelope" },
+	{ "harduc", "Harlequin Duck", "Histrionicus histrionicus" },
+	{ "kinrai4", "King Rail", "Rallus elegans" },
+	{ "amgplo", "American Golden-Plover", "Pluvialis dominica" },
+	{ "hudgod", "Hudsonian Godwit", "Limosa haemastica" },
+	{ "rudtur", "Ruddy Turnstone", "Arenaria interpres" },
+	{ "pomjae", "Pomarine Jaeger", "Stercorarius pomarinus" },
+	{ "sabgul", "Sabine's Gull", "Xema sabini" },
+	{ "franga", "Franklin's Gull", "Leucophaeus pipixcan" },
+	{ "royter1", "Royal Tern", "Thalasseus maximus" },
+	{ "snoowl1", "Snowy Owl", "Bubo scandiacus" },
+	{ "gyrfal", "Gyrfalcon", "Falco rusticolus" },
+	{ "olsfly", "Olive-sided Flycatcher", "Contopus cooperi" },
+	{ "boreal", "Boreal Chickadee", "Poecile hudsonicus" },
+	{ "kirwar", "Kirtland's Warbler", "Setophaga kirtlandii" },
+	{ "henspa", "Henslow's Sparrow", "Centronyx henslowii" },
+	{ "paibun", "Painted Bunting", "Passerina ciris" },
+};
+
+const size_t speciesCount(sizeof(species) / sizeof(species[0]));
+
+}
+
+MockEBird::MockEBird(const Options& options, const unsigned int& seed) : options(options), generator(seed)
+{
+	constexpr unsigned int locationCount(30);
+	std::uniform_real_distribution<double> latitude(42.0, 43.0), longitude(-77.0, -76.0);
+	for (unsigned int i = 0; i < locationCount; ++i)
+	{
+		Location l;
+		l.id = "L" + std::to_string(100000 + i);
+		l.name = i % 7 == 0 ? "\"The Flats\" & Marsh #" + std::to_string(i) : "Hotspot " + std::to_string(i);// Exercise escaping
+		l.latitude = latitude(generator);
+		l.longitude = longitude(generator);
+		locations.push_back(std::move(l));
+	}
+}
+
+void MockEBird::ForceBurst()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	forceBurst = true;
+}
+
+std::map<std::string, unsigned int> MockEBird::GetCounts() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return counts;
+}
+
+MockServer::Response MockEBird::Handle(const MockServer::Request& request)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (request.method == "POST" && request.target.compare(0, 7, "/notify") == 0)
+		return HandleNotification(request);
+	else if (request.method == "GET" && request.target.find("/data/obs/") != std::string::npos)
+		return HandleObservationRequest(request.target);
+
+	++counts["unexpected requests"];
+	MockServer::Response response;
+	response.status = 400;
+	response.body = "{\"errors\":[{\"title\":\"Unexpected request\",\"code\":\"\",\"status\":\"400\"}]}";
+	return response;
+}
+
+MockServer::Response MockEBird::HandleObservationRequest(const std::string& target)
+{
+	const auto now(std::chrono::system_clock::now());
+	records.erase(std::remove_if(records.begin(), records.end(), [&now](const Record& r)
+	{
+		return r.expires <= now;
+	}), records.end());
+
+	++counts["requests"];
+	const std::string speciesCode(GetSpeciesCode(target));
+	const bool detailed(speciesCode.empty());
+
+	MockServer::Response response;
+	std::uniform_real_distribution<double> outcome(0.0, 1.0);
+	double p(outcome(generator));
+	if (forceBurst || (p -= options.burstRate) < 0.0)
+	{
+		forceBurst = false;
+		++counts["bursts"];
+		response.body = BuildObservations(options.burstSize, detailed, speciesCode);
+	}
+	else if ((p -= options.emptyRate) < 0.0)
+	{
+		++counts["empty responses"];
+		response.body = "[]";
+	}
+	else if ((p -= options.rateLimitRate) < 0.0)
+	{
+		++counts["rate limited"];
+		response.status = 429;
+		response.body = "{\"errors\":[{\"title\":\"Too many requests\",\"code\":\"rate.limit\",\"status\":\"429 TOO_MANY_REQUESTS\"}]}";
+	}
+	else if ((p -= options.serverErrorRate) < 0.0)
+	{
+		++counts["server errors"];
+		response.status = 500;
+		response.contentType = "text/html";
+		response.body = "<html><body>Internal Server Error</body></html>";
+	}
+	else if ((p -= options.apiErrorRate) < 0.0)
+	{
+		++counts["API errors"];
+		response.status = 400;
+		response.body = "{\"errors\":[{\"title\":\"Field back of dataObsRecentNotableCmd: back must be less than or equal to 30\","
+			"\"code\":\"must be less than or equal to 30\",\"status\":\"400 BAD_REQUEST\"}]}";
+	}
+	else if ((p -= options.malformedRate) < 0.0)
+	{
+		++counts["malformed responses"];
+		response.body = BuildObservations(options.responseSize, detailed, speciesCode);
+		response.body.resize(Choose(response.body.size()));// Cut off somewhere
+	}
+	else
+	{
+		std::uniform_int_distribution<unsigned int> size(0, 2 * options.responseSize);
+		response.body = BuildObservations(size(generator), detailed, speciesCode);
+	}
+
+	return response;
+}
+
+MockServer::Response MockEBird::HandleNotification(const MockServer::Request& request)
+{
+	MockServer::Response response;
+	if (Chance(options.webhookFailureRate))
+	{
+		++counts["notifications rejected"];
+		response.status = 503;
+		response.body = "{\"error\":\"unavailable\"}";
+		return response;
+	}
+
+	++counts["notifications received"];
+	counts["notification kB"] += static_cast<unsigned int>(request.body.size() / 1024);
+	response.body = "{}";
+	return response;
+}
+
+std::string MockEBird::BuildObservations(const unsigned int& count, const bool& detailed, const std::string& speciesCode)
+{
+	size_t speciesIndex(0);
+	if (!detailed)
+	{
+		while (speciesIndex < speciesCount && speciesCode != species[speciesIndex].code)
+			++speciesIndex;
+		if (speciesIndex == speciesCount)
+			return "[]";
+	}
+
+	std::vector<size_t> candidates;// Previously returned records that could be returned again
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		if (detailed || records[i].species == speciesIndex)
+			candidates.push_back(i);
+	}
+
+	std::string out("[");
+	unsigned int written(0);
+	auto write([this, &out, &written, &detailed](const Record& r)
+	{
+		if (written++ > 0)
+			out.push_back(',');
+		WriteRecord(out, r, detailed);
+	});
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		// New records are appended, so candidate indices stay valid (but references don't)
+		size_t index;
+		if (!candidates.empty() && Chance(options.repeatRate))
+		{
+			index = candidates[Choose(candidates.size())];
+			if (Chance(options.reviseRate))
+				Revise(records[index]);
+		}
+		else
+			index = CreateRecord(detailed ? Choose(speciesCount) : speciesIndex);
+
+		write(records[index]);
+		if (Chance(options.duplicateRate))
+			write(records[index]);
+	}
+	out.push_back(']');
+
+	counts["observations served"] += written;
+	return out;
+}
+
+// Dated so that the record ages out of the daysBack window recordLifetime after being created
+size_t MockEBird::CreateRecord(const size_t& speciesIndex)
+{
+	std::uniform_int_distribution<unsigned int> lifetime(90, std::max(90u, options.recordLifetime));
+	std::time_t dateTime(std::time(nullptr) - options.daysBack * 24 * 3600 + lifetime(generator));
+	dateTime -= dateTime % 60;// eBird dates have minute resolution
+
+	char date[32];
+	std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M", std::localtime(&dateTime));
+
+	Record r;
+	r.observationID = "OBS" + std::to_string(nextID);
+	r.checklistID = "S" + std::to_string(nextID / 3);// Several observations per checklist
+	++nextID;
+	r.date = date;
+	r.expires = std::chrono::system_clock::from_time_t(dateTime) + std::chrono::hours(options.daysBack * 24);
+	r.species = speciesIndex;
+	r.location = Choose(locations.size());
+	r.count = 1 + static_cast<unsigned int>(Choose(20));
+	r.presenceNoted = Chance(0.1);
+	r.reviewed = false;
+	r.hasMedia = Chance(0.1);
+
+	records.push_back(std::move(r));
+	return records.size() - 1;
+}
+
+void MockEBird::Revise(Record& r)
+{
+	switch (Choose(3))
+	{
+	case 0:
+		r.reviewed = true;
+		break;
+
+	case 1:
+		r.hasMedia = true;
+		break;
+
+	default:
+		r.presenceNoted = false;
+		++r.count;
+	}
+}
+
+void MockEBird::WriteRecord(std::string& out, const Record& r, const bool& detailed) const
+{
+	const Species& s(species[r.species]);
+	const Location& l(locations[r.location]);
+
+	out.append("{\"speciesCode\":");
+	WriteJSONString(out, s.code);
+	out.append(",\"comName\":");
+	WriteJSONString(out, s.commonName);
+	out.append(",\"sciName\":");
+	WriteJSONString(out, s.scientificName);
+	out.append(",\"locID\":");
+	WriteJSONString(out, l.id);
+	out.append(",\"locName\":");
+	WriteJSONString(out, l.name);
+	out.append(",\"obsDt\":");
+	WriteJSONString(out, r.date);
+	if (!r.presenceNoted)
+		out.append(",\"howMany\":" + std::to_string(r.count));
+
+	std::ostringstream position;
+	position << std::fixed << std::setprecision(6) << ",\"lat\":" << l.latitude << ",\"lng\":" << l.longitude;
+	out.append(position.str());
+
+	out.append(",\"obsValid\":true,\"obsReviewed\":");
+	out.append(r.reviewed ? "true" : "false");
+	out.append(",\"locationPrivate\":false,\"subID\":");
+	WriteJSONString(out, r.checklistID);
+	if (detailed)
+	{
+		out.append(",\"userDisplayName\":\"Soak Tester\",\"obsId\":");
+		WriteJSONString(out, r.observationID);
+		out.append(",\"presenceNoted\":");
+		out.append(r.presenceNoted ? "true" : "false");
+		out.append(",\"hasComments\":false,\"hasRichMedia\":");
+		out.append(r.hasMedia ? "true" : "false");
+	}
+	out.push_back('}');
+}
+
+bool MockEBird::Chance(const double& p)
+{
+	return std::uniform_real_distribution<double>(0.0, 1.0)(generator) < p;
+}
+
+size_t MockEBird::Choose(const size_t& count)
+{
+	return std::uniform_int_distribution<size_t>(0, count - 1)(generator);
+}
+
+// Empty for recent/notable requests
+std::string MockEBird::GetSpeciesCode(const std::string& target)
+{
+	const std::string recent("/recent/");
+	const auto start(target.find(recent));
+	if (start == std::string::npos)
+		return std::string();
+
+	const std::string code(target.substr(start + recent.size(), target.find('?') - start - recent.size()));
+	return code == "notable" ? std::string() : code;
+}
+
+void MockEBird::WriteJSONString(std::string& out, const std::string& s)
+{
+	out.push_back('"');
+	for (const auto& c : s)
+	{
+		if (c == '"' || c == '\\')
+			out.push_back('\\');
+		out.push_back(c);
+	}
+	out.push_back('"');
+}
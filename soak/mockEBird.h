@@ -0,0 +1,104 @@
+// File:  mockEBird.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Stand-in for the eBird API (and a webhook receiving notifications) with randomized
+//        responses:  repeat and duplicate reports, revised records, large bursts, rate
+//        limiting, server and API errors and malformed payloads.
+
+#ifndef MOCK_EBIRD_H_
+#define MOCK_EBIRD_H_
+
+// Local headers
+#include "mockServer.h"
+
+// Standard C++ headers
+#include <random>
+#include <mutex>
+#include <map>
+#include <vector>
+#include <string>
+#include <chrono>
+
+class MockEBird
+{
+public:
+	struct Options
+	{
+		unsigned int daysBack = 2;// Must match the configuration under test
+		unsigned int recordLifetime = 120;// [sec] before a record is too old to be returned (and is pruned from the history); at least 90
+		unsigned int responseSize = 20;// Average observations per response
+		unsigned int burstSize = 3000;
+
+		// Probability of each kind of response
+		double burstRate = 0.02;
+		double emptyRate = 0.05;
+		double rateLimitRate = 0.03;
+		double serverErrorRate = 0.02;
+		double apiErrorRate = 0.02;
+		double malformedRate = 0.01;
+
+		double repeatRate = 0.8;// Of observations in a response, the fraction that have been returned before
+		double duplicateRate = 0.1;// Of observations in a response, the fraction that appear twice
+		double reviseRate = 0.05;// Of repeated observations, the fraction with changed details
+		double webhookFailureRate = 0.02;
+	};
+
+	MockEBird(const Options& options, const unsigned int& seed);
+
+	MockServer::Response Handle(const MockServer::Request& request);
+
+	// For sizing things during warm-up
+	void ForceBurst();
+
+	// Number of responses of each kind, observations served and notifications received
+	std::map<std::string, unsigned int> GetCounts() const;
+
+private:
+	const Options options;
+
+	mutable std::mutex mutex;
+	std::mt19937 generator;
+	bool forceBurst = false;
+	std::map<std::string, unsigned int> counts;
+
+	struct Location
+	{
+		std::string id;
+		std::string name;
+		double latitude;
+		double longitude;
+	};
+
+	struct Record
+	{
+		std::string observationID;
+		std::string checklistID;
+		std::string date;
+		std::chrono::system_clock::time_point expires;
+		size_t species;
+		size_t location;
+		unsigned int count;
+		bool presenceNoted;
+		bool reviewed;
+		bool hasMedia;
+	};
+
+	std::vector<Location> locations;// Birds tend to be reported from the same places
+	std::vector<Record> records;// Everything still recent enough to be returned
+	unsigned int nextID = 1;
+
+	MockServer::Response HandleObservationRequest(const std::string& target);
+	MockServer::Response HandleNotification(const MockServer::Request& request);
+
+	std::string BuildObservations(const unsigned int& count, const bool& detailed, const std::string& speciesCode);
+	size_t CreateRecord(const size_t& species);// Returns index into records
+	void Revise(Record& r);
+	void WriteRecord(std::string& out, const Record& r, const bool& detailed) const;
+
+	bool Chance(const double& p);
+	size_t Choose(const size_t& count);
+	static std::string GetSpeciesCode(const std::string& target);
+	static void WriteJSONString(std::string& out, const std::string& s);
+};
+
+#endif// MOCK_EBIRD_H_
@@ -0,0 +1,221 @@
+// File:  mockServer.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Minimal HTTP server on the loopback interface, for standing in for remote services
+//        during testing.  Handles one connection at a time on its own thread; every response
+//        closes the connection.
+
+// Local headers
+#include "mockServer.h"
+
+// Standard C++ headers
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+
+// *nix headers
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+MockServer::~MockServer()
+{
+	Stop();
+}
+
+bool MockServer::Start()
+{
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;// Let the system choose
+
+	socklen_t addressSize(sizeof(address));
+	listenFD = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listenFD < 0 ||
+		bind(listenFD, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+		listen(listenFD, 64) != 0 ||
+		getsockname(listenFD, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0 ||
+		pipe(stopFD) != 0)
+	{
+		log << "Failed to start mock server:  " << std::strerror(errno) << std::endl;
+		Stop();
+		return false;
+	}
+
+	port = ntohs(address.sin_port);
+	thread = std::thread(&MockServer::Serve, this);
+	return true;
+}
+
+void MockServer::Stop()
+{
+	if (thread.joinable())
+	{
+		const char c(0);
+		if (write(stopFD[1], &c, 1) != 1)
+			log << "Failed to signal mock server to stop" << std::endl;
+		thread.join();
+	}
+
+	for (auto fd : { listenFD, stopFD[0], stopFD[1] })
+	{
+		if (fd >= 0)
+			close(fd);
+	}
+	listenFD = stopFD[0] = stopFD[1] = -1;
+}
+
+std::string MockServer::GetRootURL() const
+{
+	return "http://127.0.0.1:" + std::to_string(port) + "/";
+}
+
+void MockServer::Serve()
+{
+	while (true)
+	{
+		pollfd fds[2] = { { listenFD, POLLIN, 0 }, { stopFD[0], POLLIN, 0 } };
+		if (poll(fds, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+
+		if (fds[1].revents != 0)
+			return;
+
+		if ((fds[0].revents & POLLIN) == 0)
+			continue;
+
+		const int clientFD(accept4(listenFD, nullptr, nullptr, SOCK_CLOEXEC));
+		if (clientFD < 0)
+			continue;
+
+		HandleConnection(clientFD);
+		close(clientFD);
+	}
+}
+
+void MockServer::HandleConnection(const int& clientFD)
+{
+	Request request;
+	if (!ReadRequest(clientFD, request))
+		return;
+
+	const Response response(handler(request));
+	std::ostringstream ss;
+	ss << "HTTP/1.1 " << response.status << ' ' << GetReasonPhrase(response.status) << "\r\n"
+		<< "Content-Type: " << response.contentType << "\r\n"
+		<< "Content-Length: " << response.body.size() << "\r\n"
+		<< "Connection: close\r\n\r\n";
+	if (SendAll(clientFD, ss.str()))
+		SendAll(clientFD, response.body);
+}
+
+bool MockServer::ReadRequest(const int& clientFD, Request& request)
+{
+	constexpr size_t maxHeaderSize(64 * 1024);
+	std::string data;
+	size_t headerEnd;
+	while ((headerEnd = data.find("\r\n\r\n")) == std::string::npos)
+	{
+		char buffer[4096];
+		ssize_t n;
+		if (data.size() > maxHeaderSize || !WaitForData(clientFD) || (n = read(clientFD, buffer, sizeof(buffer))) <= 0)
+			return false;
+		data.append(buffer, n);
+	}
+
+	std::istringstream headers(data.substr(0, headerEnd));
+	std::string line;
+	std::getline(headers, line);
+	std::istringstream requestLine(line);
+	if (!(requestLine >> request.method >> request.target))
+		return false;
+
+	size_t contentLength(0);
+	bool expectContinue(false);
+	while (std::getline(headers, line))
+	{
+		const auto colon(line.find(':'));
+		if (colon == std::string::npos)
+			continue;
+
+		std::string name(line.substr(0, colon));
+		std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char& c) { return std::tolower(c); });
+		std::string value(line.substr(colon + 1));
+		value.erase(0, value.find_first_not_of(" \t"));
+		value.erase(value.find_last_not_of(" \t\r") + 1);
+
+		if (name == "content-length")
+			contentLength = std::strtoul(value.c_str(), nullptr, 10);
+		else if (name == "expect")
+			expectContinue = true;
+	}
+
+	// Otherwise curl waits a second before sending larger bodies
+	if (expectContinue && !SendAll(clientFD, "HTTP/1.1 100 Continue\r\n\r\n"))
+		return false;
+
+	request.body = data.substr(headerEnd + 4);
+	while (request.body.size() < contentLength)
+	{
+		char buffer[16 * 1024];
+		ssize_t n;
+		if (!WaitForData(clientFD) || (n = read(clientFD, buffer, std::min(sizeof(buffer), contentLength - request.body.size()))) <= 0)
+			return false;
+		request.body.append(buffer, n);
+	}
+
+	return true;
+}
+
+bool MockServer::WaitForData(const int& fd)
+{
+	constexpr int timeout(5000);// [ms]
+	pollfd p{ fd, POLLIN, 0 };
+	return poll(&p, 1, timeout) > 0;
+}
+
+bool MockServer::SendAll(const int& fd, const std::string& data)
+{
+	for (size_t written = 0; written < data.size();)
+	{
+		const ssize_t n(send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL));
+		if (n <= 0)
+			return false;// Client went away
+		written += n;
+	}
+	return true;
+}
+
+std::string MockServer::GetReasonPhrase(const unsigned int& status)
+{
+	switch (status)
+	{
+	case 200:
+		return "OK";
+
+	case 400:
+		return "Bad Request";
+
+	case 429:
+		return "Too Many Requests";
+
+	case 500:
+		return "Internal Server Error";
+
+	case 503:
+		return "Service Unavailable";
+
+	default:
+		return "Unknown";
+	}
+}
@@ -0,0 +1,67 @@
+// File:  mockServer.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Minimal HTTP server on the loopback interface, for standing in for remote services
+//        during testing.  Handles one connection at a time on its own thread; every response
+//        closes the connection.
+
+#ifndef MOCK_SERVER_H_
+#define MOCK_SERVER_H_
+
+// Local headers
+#include "utilities/uString.h"
+
+// Standard C++ headers
+#include <functional>
+#include <thread>
+#include <string>
+
+class MockServer
+{
+public:
+	struct Request
+	{
+		std::string method;
+		std::string target;// Path and query
+		std::string body;
+	};
+
+	struct Response
+	{
+		unsigned int status = 200;
+		std::string contentType = "application/json";
+		std::string body;
+	};
+
+	typedef std::function<Response(const Request&)> Handler;
+
+	MockServer(const Handler& handler, UString::OStream& log) : handler(handler), log(log) {}
+	~MockServer();
+
+	MockServer(const MockServer&) = delete;
+	MockServer& operator=(const MockServer&) = delete;
+
+	bool Start();// On an unused port
+	void Stop();
+
+	// e.g. http://127.0.0.1:12345/
+	std::string GetRootURL() const;
+
+private:
+	const Handler handler;
+	UString::OStream& log;
+
+	std::thread thread;
+	int listenFD = -1;
+	int stopFD[2] = { -1, -1 };// Written to wake the server thread when stopping
+	unsigned short port = 0;
+
+	void Serve();
+	void HandleConnection(const int& clientFD);
+	bool ReadRequest(const int& clientFD, Request& request);
+	static bool WaitForData(const int& fd);
+	static bool SendAll(const int& fd, const std::string& data);
+	static std::string GetReasonPhrase(const unsigned int& status);
+};
+
+#endif// MOCK_SERVER_H_
@@ -0,0 +1,100 @@
+// File:  processMonitor.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Samples the resource usage of this process (memory, allocations, open files) for the soak test.
+
+// Local headers
+#include "processMonitor.h"
+
+// Standard C++ headers
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <fstream>
+#include <filesystem>
+
+// *nix headers
+#include <malloc.h>
+#include <unistd.h>
+
+namespace
+{
+
+std::atomic<uint64_t> allocationCount(0);
+std::atomic<uint64_t> deallocationCount(0);
+std::atomic<int64_t> allocatedBytes(0);
+
+void* CountedAllocate(const std::size_t& size, const std::size_t& alignment)
+{
+	void* p(nullptr);
+	if (alignment <= alignof(std::max_align_t))
+		p = std::malloc(size == 0 ? 1 : size);
+	else if (posix_memalign(&p, alignment, size == 0 ? 1 : size) != 0)
+		p = nullptr;
+
+	if (!p)
+		throw std::bad_alloc();
+
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+	return p;
+}
+
+void CountedFree(void* p) noexcept
+{
+	if (!p)
+		return;
+
+	deallocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+	std::free(p);
+}
+
+}
+
+// The remaining forms (array and nothrow) are implemented by the standard library in terms of these
+void* operator new(std::size_t size) { return CountedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return CountedAllocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { CountedFree(p); }
+
+ProcessMonitor::Sample ProcessMonitor::Take()
+{
+	Sample s;
+	s.residentBytes = GetResidentBytes();
+	s.totalAllocations = allocationCount.load(std::memory_order_relaxed);
+	s.liveAllocations = s.totalAllocations - deallocationCount.load(std::memory_order_relaxed);
+	s.liveAllocatedBytes = static_cast<uint64_t>(allocatedBytes.load(std::memory_order_relaxed));
+	s.liveCHeapBytes = GetCHeapBytes();
+	s.openFiles = CountOpenFiles();
+	return s;
+}
+
+uint64_t ProcessMonitor::GetResidentBytes()
+{
+	// Second field is resident set size in pages
+	std::ifstream statm("/proc/self/statm");
+	uint64_t totalPages, residentPages;
+	if (!(statm >> totalPages >> residentPages))
+		return 0;
+	return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// The operator new counts only see C++ allocations, so this is what catches leaks inside C libraries
+uint64_t ProcessMonitor::GetCHeapBytes()
+{
+	const struct mallinfo2 info(mallinfo2());// Summed over all of malloc's arenas (i.e. all threads)
+	return info.uordblks + info.hblkhd;// Includes blocks large enough to have been given their own mapping
+}
+
+unsigned int ProcessMonitor::CountOpenFiles()
+{
+	std::error_code ec;
+	unsigned int count(0);
+	for (std::filesystem::directory_iterator it("/proc/self/fd", ec), end; !ec && it != end; it.increment(ec))
+		++count;
+	return count > 0 ? count - 1 : 0;// Don't count the descriptor used for iterating
+}
@@ -0,0 +1,33 @@
+// File:  processMonitor.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Samples the resource usage of this process (memory, allocations, open files) for the soak test.
+
+#ifndef PROCESS_MONITOR_H_
+#define PROCESS_MONITOR_H_
+
+// Standard C++ headers
+#include <cstdint>
+
+class ProcessMonitor
+{
+public:
+	struct Sample
+	{
+		uint64_t residentBytes = 0;
+		uint64_t liveAllocations = 0;// operator new calls not yet matched by a delete
+		uint64_t liveAllocatedBytes = 0;
+		uint64_t totalAllocations = 0;// Since startup
+		uint64_t liveCHeapBytes = 0;// Everything in use on the malloc heap, including what C libraries (curl, cJSON, zlib) allocate
+		unsigned int openFiles = 0;
+	};
+
+	static Sample Take();
+
+private:
+	static uint64_t GetResidentBytes();
+	static uint64_t GetCHeapBytes();
+	static unsigned int CountOpenFiles();
+};
+
+#endif// PROCESS_MONITOR_H_
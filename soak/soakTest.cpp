@@ -0,0 +1,456 @@
+// File:  soakTest.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Drives BirdNotifier in long-running mode against local mock eBird and webhook endpoints
+//        for many cycles, recording latency, memory, allocations and open files for each cycle.
+//        Fails if resource usage keeps growing once warmed up (i.e. something leaks) or if
+//        latency regresses, either over the course of the run or against a saved baseline.
+
+// Local headers
+#include "mockEBird.h"
+#include "mockServer.h"
+#include "processMonitor.h"
+#include "birdNotifier.h"
+#include "statusServer.h"
+#include "email/cJSON/cJSON.h"
+
+// Standard C++ headers
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+// *nix headers
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+struct SoakOptions
+{
+	unsigned int cycles = 5000;
+	unsigned int interval = 50;// [ms] between cycles
+	unsigned int warmup = 150;// [sec]; long enough for the history to reach steady state (see MockEBird::Options::recordLifetime)
+	unsigned int seed = std::random_device()();
+	unsigned int reportEvery = 100;// [cycles]
+	std::string workDirectory = "soak.tmp";
+	std::string csvFile;
+	std::string baselineFile;// Compare steady-state latency with this
+	std::string saveBaselineFile;
+	double latencyTolerance = 1.5;// Ratio of p95 latency (late in the run vs. early, or vs. baseline) considered a regression
+	unsigned int maxLatency = 10000;// [ms] for any one cycle
+	unsigned int heapParseEvery = 4;// [cycles]; parse outside the poll arena, where cJSON leaks aren't reclaimed (zero for never)
+	bool compressHistory = false;
+	bool injectLeak = false;// To check that leaks are caught
+	bool injectMallocLeak = false;
+	bool injectCJSONLeak = false;
+};
+
+struct CycleSample
+{
+	unsigned int cycle;
+	double elapsed;// [sec] since start of run
+	bool succeeded;
+	bool statusOK;
+	double latency;// [ms]
+	uint64_t allocations;// During this cycle
+	ProcessMonitor::Sample process;// After this cycle
+};
+
+static char* volatile leakedBlock(nullptr);// For --inject-leak; never freed
+static void* volatile leakedCBlock(nullptr);// For --inject-malloc-leak; never freed
+static cJSON* volatile leakedTree(nullptr);// For --inject-cjson-leak; never freed
+
+void PrintUsage(const std::string& calledAs)
+{
+	const SoakOptions defaults;
+	std::cout << "Usage:  " << calledAs << " [options]\n"
+		<< "  --cycles <n>                Number of poll cycles (default " << defaults.cycles << ")\n"
+		<< "  --interval <ms>             Pause between cycles (default " << defaults.interval << ")\n"
+		<< "  --warmup <sec>              Cycles in this period are excluded from checks (default " << defaults.warmup << ")\n"
+		<< "  --seed <n>                  Seed for the randomized responses (default random)\n"
+		<< "  --report-every <n>          Cycles per progress report (default " << defaults.reportEvery << ")\n"
+		<< "  --work-dir <dir>            Scratch directory; emptied at start (default " << defaults.workDirectory << ")\n"
+		<< "  --csv <file>                Write per-cycle measurements\n"
+		<< "  --baseline <file>           Fail if steady-state latency is worse than in this file\n"
+		<< "  --save-baseline <file>      Write steady-state latency for use with --baseline\n"
+		<< "  --latency-tolerance <x>     Slowdown ratio treated as a regression (default " << defaults.latencyTolerance << ")\n"
+		<< "  --max-latency <ms>          Fail if any cycle takes longer (default " << defaults.maxLatency << ")\n"
+		<< "  --heap-parse-every <n>      Parse responses outside the poll arena every nth cycle, so parser leaks show (default "
+			<< defaults.heapParseEvery << "; 0 for never)\n"
+		<< "  --compress-history          Store the notification history compressed\n"
+		<< "  --inject-leak               Leak a little memory every cycle (to check that leaks are detected)\n"
+		<< "  --inject-malloc-leak        Leak a little memory with malloc every cycle (to check that leaks in C libraries are detected)\n"
+		<< "  --inject-cjson-leak         Leak a cJSON tree every cycle (to check that parser leaks are detected)" << std::endl;
+}
+
+bool ParseArguments(int argc, char* argv[], SoakOptions& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string argument(argv[i]);
+		const bool hasValue(i + 1 < argc);
+		if (argument == "--compress-history")
+			options.compressHistory = true;
+		else if (argument == "--inject-leak")
+			options.injectLeak = true;
+		else if (argument == "--inject-malloc-leak")
+			options.injectMallocLeak = true;
+		else if (argument == "--inject-cjson-leak")
+			options.injectCJSONLeak = true;
+		else if (!hasValue)
+			return false;
+		else if (argument == "--cycles")
+			options.cycles = std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--interval")
+			options.interval = std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--warmup")
+			options.warmup = std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--seed")
+			options.seed = std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--heap-parse-every")
+			options.heapParseEvery = std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--report-every")
+			options.reportEvery = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+		else if (argument == "--work-dir")
+			options.workDirectory = argv[++i];
+		else if (argument == "--csv")
+			options.csvFile = argv[++i];
+		else if (argument == "--baseline")
+			options.baselineFile = argv[++i];
+		else if (argument == "--save-baseline")
+			options.saveBaselineFile = argv[++i];
+		else if (argument == "--latency-tolerance")
+			options.latencyTolerance = std::strtod(argv[++i], nullptr);
+		else if (argument == "--max-latency")
+			options.maxLatency = std::strtoul(argv[++i], nullptr, 10);
+		else
+			return false;
+	}
+
+	return options.cycles > 0 && options.latencyTolerance >= 1.0;
+}
+
+std::shared_ptr<BirdNotifierConfig> BuildConfiguration(const SoakOptions& options, const MockServer& server, const MockEBird::Options& mockOptions)
+{
+	auto config(std::make_shared<BirdNotifierConfig>());
+	const std::filesystem::path directory(options.workDirectory);
+	config->alreadyNotifiedFile = (directory / "history").string();
+	config->compressHistory = options.compressHistory;
+	config->pollInterval = 1;
+	config->statusSocket = (directory / "status.sock").string();
+	config->eBirdAPIKey = "soak";
+	config->eBirdAPIRoot = server.GetRootURL() + "v2/";
+
+	for (const auto& region : { "US-NY", "US-PA", "US-NJ" })
+	{
+		WatchConfig w;
+		w.regionCode = region;
+		config->watches.push_back(w);
+	}
+
+	WatchConfig point;
+	point.latitude = 42.5;
+	point.longitude = -76.5;
+	point.radius = 25.0;
+	config->watches.push_back(point);
+
+	WatchConfig speciesWatch;
+	speciesWatch.regionCode = "US-NY";
+	speciesWatch.speciesCodes = { "snoowl1", "kirwar" };
+	config->watches.push_back(speciesWatch);
+
+	config->notifyUpdates = true;
+	config->daysBack = mockOptions.daysBack;
+	config->clusterEvents = true;
+	config->clusterDistance = 5.0;
+	config->clusterWindow = 3;
+	config->taxonomyFile = (directory / "taxonomy").string();
+	config->taxonomyMaxAge = 30;
+
+	// Retrying backs off for several seconds, which would swamp the latency measurements
+	config->transports = { "webhook" };
+	config->deliveryAttempts = 1;
+	config->webhookURLs = { server.GetRootURL() + "notify" };
+	config->emailInfo.sender = "soak@example.com";
+	config->emailInfo.recipients = { "soak@example.com" };
+
+	return config;
+}
+
+bool QueryStatus(const std::string& socketPath)
+{
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+	const int fd(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+	if (fd < 0)
+		return false;
+
+	const std::string request("GET / HTTP/1.0\r\n\r\n");
+	std::string response;
+	if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0 &&
+		send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size()))
+	{
+		char buffer[16 * 1024];
+		ssize_t n;
+		while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+			response.append(buffer, n);
+	}
+	close(fd);
+
+	return response.compare(0, 15, "HTTP/1.0 200 OK") == 0 && response.find("\"cycle\":") != std::string::npos;
+}
+
+// Nearest rank
+template<typename T, typename Getter>
+T Percentile(const std::vector<CycleSample>& samples, const double& p, Getter get)
+{
+	if (samples.empty())
+		return T();
+
+	std::vector<T> values;
+	values.reserve(samples.size());
+	for (const auto& s : samples)
+		values.push_back(get(s));
+
+	const size_t rank(std::min(values.size() - 1, static_cast<size_t>(p / 100.0 * values.size())));
+	std::nth_element(values.begin(), values.begin() + rank, values.end());
+	return values[rank];
+}
+
+double LatencyPercentile(const std::vector<CycleSample>& samples, const double& p)
+{
+	return Percentile<double>(samples, p, [](const CycleSample& s) { return s.latency; });
+}
+
+void PrintWindow(const std::vector<CycleSample>& window)
+{
+	constexpr double mebibyte(1024.0 * 1024.0);
+	const auto failed(std::count_if(window.begin(), window.end(), [](const CycleSample& s) { return !s.succeeded; }));
+	const auto& last(window.back().process);
+	std::cout << "Cycles " << std::setw(5) << window.front().cycle << '-' << std::setw(5) << window.back().cycle << ":  "
+		<< std::fixed << std::setprecision(1)
+		<< "latency p50 " << LatencyPercentile(window, 50.0) << " / p95 " << LatencyPercentile(window, 95.0)
+		<< " / p99 " << LatencyPercentile(window, 99.0) << " ms; "
+		<< Percentile<uint64_t>(window, 50.0, [](const CycleSample& s) { return s.allocations; }) << " allocations/cycle; "
+		<< "RSS " << last.residentBytes / mebibyte << " MiB; heap " << last.liveAllocatedBytes / mebibyte << " MiB in "
+		<< last.liveAllocations << " blocks; C heap " << last.liveCHeapBytes / mebibyte << " MiB; " << last.openFiles << " open files; " << failed << " failed" << std::endl;
+}
+
+// Growth per cycle between the first and second halves of the steady-state samples, using medians to
+// ignore the odd burst.  A leak shows up as steady growth; there's a floor on the total as well, so
+// noise over short runs doesn't count.
+bool CheckGrowth(const std::string& name, const std::vector<CycleSample>& steady, uint64_t (*get)(const CycleSample&),
+	const double& maxPerCycle, const double& minimumTotal)
+{
+	const std::vector<CycleSample> early(steady.begin(), steady.begin() + steady.size() / 2);
+	const std::vector<CycleSample> late(steady.begin() + steady.size() / 2, steady.end());
+	const double growth(static_cast<double>(Percentile<uint64_t>(late, 50.0, get)) - static_cast<double>(Percentile<uint64_t>(early, 50.0, get)));
+	const double perCycle(growth / (late.size() / 2.0 + early.size() / 2.0));
+
+	const bool ok(perCycle <= maxPerCycle || growth <= minimumTotal);
+	std::cout << (ok ? "PASS" : "FAIL") << "  " << name << " grew by " << std::setprecision(0) << growth
+		<< " (" << std::setprecision(2) << perCycle << " per cycle; limit " << maxPerCycle << ")" << std::endl;
+	return ok;
+}
+
+bool CheckLatency(const std::string& name, const double& measured, const double& reference, const double& tolerance)
+{
+	constexpr double allowance(5.0);// [ms] so jitter on very fast cycles isn't a regression
+	const double limit(reference * tolerance + allowance);
+	const bool ok(measured <= limit);
+	std::cout << (ok ? "PASS" : "FAIL") << "  " << name << " " << std::setprecision(1) << measured
+		<< " ms (limit " << limit << " ms)" << std::endl;
+	return ok;
+}
+
+bool ReadBaseline(const std::string& fileName, double& p50, double& p95, double& p99)
+{
+	std::ifstream file(fileName);
+	std::string label50, label95, label99;
+	return static_cast<bool>(file >> label50 >> p50 >> label95 >> p95 >> label99 >> p99) &&
+		label50 == "p50" && label95 == "p95" && label99 == "p99";
+}
+
+bool WriteBaseline(const std::string& fileName, const std::vector<CycleSample>& steady)
+{
+	std::ofstream file(fileName);
+	file << std::fixed << std::setprecision(3) << "p50 " << LatencyPercentile(steady, 50.0) << "\np95 "
+		<< LatencyPercentile(steady, 95.0) << "\np99 " << LatencyPercentile(steady, 99.0) << '\n';
+	return file.good();
+}
+
+bool Analyze(const SoakOptions& options, const std::vector<CycleSample>& samples)
+{
+	const auto steadyStart(std::find_if(samples.begin(), samples.end(), [&options, &samples](const CycleSample& s)
+	{
+		return s.elapsed >= options.warmup && s.cycle > samples.size() / 10;
+	}));
+
+	constexpr size_t minimumSteadyCycles(20);
+	const std::vector<CycleSample> steady(steadyStart, samples.end());
+	if (steady.size() < minimumSteadyCycles)
+	{
+		std::cout << "FAIL  Only " << steady.size() << " cycles after warm-up; need at least " << minimumSteadyCycles
+			<< " (run more cycles or shorten --warmup)" << std::endl;
+		return false;
+	}
+
+	std::cout << "\nSteady state (cycles " << steady.front().cycle << '-' << steady.back().cycle << "):" << std::endl;
+	PrintWindow(steady);
+
+	bool ok(true);
+	ok = CheckGrowth("Live allocations", steady, [](const CycleSample& s) { return s.process.liveAllocations; }, 0.5, 100.0) && ok;
+	ok = CheckGrowth("Live heap bytes", steady, [](const CycleSample& s) { return s.process.liveAllocatedBytes; }, 256.0, 64.0 * 1024.0) && ok;
+	ok = CheckGrowth("Resident bytes", steady, [](const CycleSample& s) { return s.process.residentBytes; }, 4096.0, 4.0 * 1024.0 * 1024.0) && ok;
+	ok = CheckGrowth("Live C heap bytes", steady, [](const CycleSample& s) { return s.process.liveCHeapBytes; }, 256.0, 64.0 * 1024.0) && ok;
+	ok = CheckGrowth("Open files", steady, [](const CycleSample& s) { return static_cast<uint64_t>(s.process.openFiles); }, 0.0, 0.0) && ok;
+
+	const std::vector<CycleSample> early(steady.begin(), steady.begin() + steady.size() / 2);
+	const std::vector<CycleSample> late(steady.begin() + steady.size() / 2, steady.end());
+	ok = CheckLatency("Late-run p95 latency", LatencyPercentile(late, 95.0), LatencyPercentile(early, 95.0), options.latencyTolerance) && ok;
+
+	const double slowest(LatencyPercentile(steady, 100.0));
+	const bool slowestOK(slowest <= options.maxLatency);
+	std::cout << (slowestOK ? "PASS" : "FAIL") << "  Slowest cycle " << std::setprecision(1) << slowest << " ms (limit " << options.maxLatency << " ms)" << std::endl;
+	ok = slowestOK && ok;
+
+	const auto statusFailures(std::count_if(samples.begin(), samples.end(), [](const CycleSample& s) { return !s.statusOK; }));
+	std::cout << (statusFailures == 0 ? "PASS" : "FAIL") << "  " << statusFailures << " failed status queries" << std::endl;
+	ok = statusFailures == 0 && ok;
+
+	if (!options.baselineFile.empty())
+	{
+		double p50, p95, p99;
+		if (ReadBaseline(options.baselineFile, p50, p95, p99))
+		{
+			ok = CheckLatency("p50 latency vs. baseline", LatencyPercentile(steady, 50.0), p50, options.latencyTolerance) && ok;
+			ok = CheckLatency("p95 latency vs. baseline", LatencyPercentile(steady, 95.0), p95, options.latencyTolerance) && ok;
+			ok = CheckLatency("p99 latency vs. baseline", LatencyPercentile(steady, 99.0), p99, options.latencyTolerance) && ok;
+		}
+		else
+		{
+			std::cout << "FAIL  Could not read baseline from '" << options.baselineFile << "'" << std::endl;
+			ok = false;
+		}
+	}
+
+	if (!options.saveBaselineFile.empty() && !WriteBaseline(options.saveBaselineFile, steady))
+	{
+		std::cout << "Failed to write baseline to '" << options.saveBaselineFile << "'" << std::endl;
+		ok = false;
+	}
+
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	SoakOptions options;
+	if (!ParseArguments(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	// Observation dates are local time; using UTC means daylight saving can't shift when records age out
+	setenv("TZ", "UTC", 1);
+	tzset();
+
+	std::error_code ec;
+	std::filesystem::remove_all(options.workDirectory, ec);
+	if (!std::filesystem::create_directories(options.workDirectory, ec))
+	{
+		std::cerr << "Failed to create '" << options.workDirectory << "'" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Soak testing for " << options.cycles << " cycles with seed " << options.seed << std::endl;
+
+	const MockEBird::Options mockOptions;
+	MockEBird mock(mockOptions, options.seed);
+	MockServer server([&mock](const MockServer::Request& request) { return mock.Handle(request); }, Cout);
+	if (!server.Start())
+		return 1;
+
+	auto config(BuildConfiguration(options, server, mockOptions));
+	UString::OFStream log(UString::ToStringType((std::filesystem::path(options.workDirectory) / "birdNotifier.log").string()));
+	BirdNotifier birdNotifier(config, log);
+	StatusServer statusServer([&birdNotifier]() { return birdNotifier.GetSnapshot(); }, log);
+	if (!statusServer.Start(config->statusSocket))
+		return 1;
+
+	std::ofstream csv;
+	if (!options.csvFile.empty())
+	{
+		csv.open(options.csvFile);
+		csv << "cycle,elapsed_s,succeeded,latency_ms,allocations,live_allocations,live_bytes,live_c_heap_bytes,rss_bytes,open_files\n";
+	}
+
+	// The poll arena keeps its largest size, so make sure that's reached during warm-up
+	mock.ForceBurst();
+
+	std::vector<CycleSample> samples;
+	samples.reserve(options.cycles);
+	const auto start(std::chrono::steady_clock::now());
+	for (unsigned int cycle = 1; cycle <= options.cycles; ++cycle)
+	{
+		// Exercise configuration updates (contents unchanged)
+		if (cycle % 100 == 0)
+			birdNotifier.UpdateConfiguration(std::make_shared<const BirdNotifierConfig>(*config));
+
+		birdNotifier.SetParseInArena(options.heapParseEvery == 0 || cycle % options.heapParseEvery != 0);
+
+		const auto before(ProcessMonitor::Take());
+		const auto cycleStart(std::chrono::steady_clock::now());
+		CycleSample s;
+		s.cycle = cycle;
+		s.succeeded = birdNotifier.Run();
+		const auto cycleEnd(std::chrono::steady_clock::now());
+		s.statusOK = QueryStatus(config->statusSocket);
+		if (options.injectLeak)
+			leakedBlock = new char[4096];
+		if (options.injectMallocLeak)
+			leakedCBlock = std::malloc(1024);// About the size of a leaked curl header list
+		if (options.injectCJSONLeak)
+			leakedTree = cJSON_Parse("{\"leaked\":[1,2,3]}");
+
+		s.process = ProcessMonitor::Take();
+		s.latency = std::chrono::duration<double, std::milli>(cycleEnd - cycleStart).count();
+		s.elapsed = std::chrono::duration<double>(cycleEnd - start).count();
+		s.allocations = s.process.totalAllocations - before.totalAllocations;
+		samples.push_back(s);
+
+		if (csv.is_open())
+			csv << s.cycle << ',' << s.elapsed << ',' << s.succeeded << ',' << s.latency << ',' << s.allocations << ','
+				<< s.process.liveAllocations << ',' << s.process.liveAllocatedBytes << ',' << s.process.liveCHeapBytes << ','
+				<< s.process.residentBytes << ',' << s.process.openFiles << '\n';
+
+		if (cycle % options.reportEvery == 0 || cycle == options.cycles)
+			PrintWindow(std::vector<CycleSample>(samples.end() - ((cycle - 1) % options.reportEvery + 1), samples.end()));
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(options.interval));
+	}
+
+	statusServer.Stop();
+	server.Stop();
+
+	std::cout << "\nMock server:" << std::endl;
+	for (const auto& count : mock.GetCounts())
+		std::cout << "  " << count.first << ":  " << count.second << std::endl;
+
+	const bool ok(Analyze(options, samples));
+	std::cout << (ok ? "\nSoak test passed" : "\nSoak test FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+// File:  asyncCurl.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Single-threaded asynchronous HTTP layer built on the curl multi interface.
+//        Requests are exposed as awaitables so many transfers can be in flight at
+//        once from C++20 coroutines without one thread per request.
+
+// Local headers
+#include "asyncCurl.h"
+#include "email/curlUtilities.h"
+
+// Standard C++ headers
+#include <cassert>
+#include <mutex>
+#include <algorithm>
+
+#ifndef _WIN32
+// *nix headers
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif// _WIN32
+
+AsyncCurl::AsyncCurl(UString::OStream& log) : log(log), multiHandle(CreateMultiHandle())
+{
+	assert(multiHandle && "failed to create curl multi handle");
+
+#ifndef _WIN32
+	epollFD = epoll_create1(EPOLL_CLOEXEC);
+	if (epollFD < 0)
+		log << "Failed to create epoll instance:  " << std::strerror(errno) << std::endl;
+
+	curl_multi_setopt(multiHandle, CURLMOPT_SOCKETFUNCTION, SocketCallback);
+	curl_multi_setopt(multiHandle, CURLMOPT_SOCKETDATA, this);
+	curl_multi_setopt(multiHandle, CURLMOPT_TIMERFUNCTION, TimerCallback);
+	curl_multi_setopt(multiHandle, CURLMOPT_TIMERDATA, this);
+#endif// _WIN32
+}
+
+// curl's global initialization (SSL libraries, etc.) isn't thread-safe and isn't free, so it's done
+// explicitly, once, and only when a request is actually going to be made
+CURLM* AsyncCurl::CreateMultiHandle()
+{
+	static std::once_flag initialized;
+	std::call_once(initialized, []()
+	{
+		curl_global_init(CURL_GLOBAL_DEFAULT);
+	});
+
+	return curl_multi_init();
+}
+
+AsyncCurl::~AsyncCurl()
+{
+	assert(activeRequests.empty() && "destroying event loop with transfers in flight");
+	curl_multi_cleanup(multiHandle);
+
+#ifndef _WIN32
+	if (epollFD >= 0)
+		close(epollFD);
+#endif// _WIN32
+}
+
+AsyncCurl::Request::Request(AsyncCurl& loop, const UString::String& url, const std::string* postData,
+	CurlModification modification) : loop(loop), url(UString::ToNarrowString(url)), isPost(postData != nullptr),
+	postData(postData ? *postData : std::string()), modification(std::move(modification))
+{
+}
+
+bool AsyncCurl::Request::await_suspend(std::coroutine_handle<> h)
+{
+	waiter = h;
+	return loop.StartTransfer(*this);// If the transfer fails to start, resume immediately with !response.ok
+}
+
+AsyncCurl::Request AsyncCurl::Get(const UString::String& url, CurlModification modification)
+{
+	return Request(*this, url, nullptr, std::move(modification));
+}
+
+AsyncCurl::Request AsyncCurl::Post(const UString::String& url, const std::string& data, CurlModification modification)
+{
+	return Request(*this, url, &data, std::move(modification));
+}
+
+bool AsyncCurl::StartTransfer(Request& request)
+{
+	request.curl = curl_easy_init();
+	if (!request.curl)
+	{
+		log << "Failed to initialize CURL" << std::endl;
+		return false;
+	}
+
+	auto fail([&request]()
+	{
+		curl_easy_cleanup(request.curl);
+		request.curl = nullptr;
+		return false;
+	});
+
+	if (CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_URL, request.url.c_str()), _T("Failed to set URL")) ||
+		CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_WRITEFUNCTION, WriteCallback), _T("Failed to set write callback")) ||
+		CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_WRITEDATA, &request.response.body), _T("Failed to set write data")) ||
+		CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_PRIVATE, &request), _T("Failed to set private data")))
+		return fail();
+
+	if (verbose && CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_VERBOSE, 1L), _T("Failed to set verbose output")))
+		return fail();
+
+	if (!caCertificatePath.empty() && CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_CAINFO,
+		UString::ToNarrowString(caCertificatePath).c_str()), _T("Failed to set CA certificate path")))
+		return fail();
+
+	if (request.isPost)
+	{
+		if (CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_POSTFIELDS, request.postData.c_str()), _T("Failed to set post data")) ||
+			CURLUtilities::CURLCallHasError(curl_easy_setopt(request.curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.postData.size())), _T("Failed to set post data size")))
+			return fail();
+	}
+
+	if (request.modification && !request.modification(request.curl))
+		return fail();
+
+	const CURLMcode result(curl_multi_add_handle(multiHandle, request.curl));
+	if (result != CURLM_OK)
+	{
+		log << "Failed to add transfer:  " << curl_multi_strerror(result) << std::endl;
+		return fail();
+	}
+
+	activeRequests.insert(&request);
+	return true;
+}
+
+void AsyncCurl::ProcessCompletedTransfers()
+{
+	int messagesLeft;
+	while (CURLMsg* message = curl_multi_info_read(multiHandle, &messagesLeft))
+	{
+		if (message->msg != CURLMSG_DONE)
+			continue;
+
+		Request* request(nullptr);
+		curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &request);
+		assert(request);
+
+		request->response.ok = !CURLUtilities::CURLCallHasError(message->data.result, _T("Failed issuing request"));
+		curl_easy_getinfo(message->easy_handle, CURLINFO_RESPONSE_CODE, &request->response.httpCode);
+
+		curl_multi_remove_handle(multiHandle, message->easy_handle);
+		curl_easy_cleanup(message->easy_handle);
+		request->curl = nullptr;
+		activeRequests.erase(request);
+
+		// May start new transfers, which is fine - they'll be picked up on the next pass through the loop
+		request->waiter.resume();
+	}
+}
+
+// The waiting coroutines usually own the requests (and anything else curl points to, e.g. header lists) and
+// are about to be destroyed, so the handles have to be detached from the multi handle first
+void AsyncCurl::AbandonTransfers()
+{
+	for (Request* request : activeRequests)
+	{
+		curl_multi_remove_handle(multiHandle, request->curl);
+		curl_easy_cleanup(request->curl);
+		request->curl = nullptr;
+	}
+
+	activeRequests.clear();
+}
+
+size_t AsyncCurl::WriteCallback(char* ptr, size_t size, size_t nmemb, void* userData)
+{
+	const size_t totalSize(size * nmemb);
+	static_cast<std::string*>(userData)->append(ptr, totalSize);
+	return totalSize;
+}
+
+#ifndef _WIN32
+
+int AsyncCurl::SocketCallback(CURL*, curl_socket_t s, int what, void* userp, void*)
+{
+	AsyncCurl* loop(static_cast<AsyncCurl*>(userp));
+	if (what == CURL_POLL_REMOVE)
+	{
+		if (loop->watchedSockets.erase(s) > 0)
+			epoll_ctl(loop->epollFD, EPOLL_CTL_DEL, s, nullptr);
+		return 0;
+	}
+
+	epoll_event event{};
+	event.data.fd = s;
+	if (what == CURL_POLL_IN || what == CURL_POLL_INOUT)
+		event.events |= EPOLLIN;
+	if (what == CURL_POLL_OUT || what == CURL_POLL_INOUT)
+		event.events |= EPOLLOUT;
+
+	const bool isNew(loop->watchedSockets.insert(s).second);
+	if (epoll_ctl(loop->epollFD, isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, s, &event) != 0)
+	{
+		loop->log << "Failed to update epoll registration:  " << std::strerror(errno) << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int AsyncCurl::TimerCallback(CURLM*, long timeoutMS, void* userp)
+{
+	AsyncCurl* loop(static_cast<AsyncCurl*>(userp));
+	loop->timerSet = timeoutMS >= 0;
+	if (loop->timerSet)
+		loop->timerDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+	return 0;
+}
+
+bool AsyncCurl::Run()
+{
+	if (epollFD < 0)
+	{
+		AbandonTransfers();
+		return false;
+	}
+
+	constexpr int maxEvents(64);
+	epoll_event events[maxEvents];
+	int runningHandles;
+
+	while (!activeRequests.empty())
+	{
+		int waitMS(-1);
+		if (timerSet)
+			waitMS = static_cast<int>(std::max(std::chrono::milliseconds(0),
+				std::chrono::ceil<std::chrono::milliseconds>(timerDeadline - std::chrono::steady_clock::now())).count());
+
+		const int eventCount(epoll_wait(epollFD, events, maxEvents, waitMS));
+		if (eventCount < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			log << "epoll_wait failed:  " << std::strerror(errno) << std::endl;
+			AbandonTransfers();
+			return false;
+		}
+
+		for (int i = 0; i < eventCount; ++i)
+		{
+			int flags(0);
+			if (events[i].events & EPOLLIN)
+				flags |= CURL_CSELECT_IN;
+			if (events[i].events & EPOLLOUT)
+				flags |= CURL_CSELECT_OUT;
+			if (events[i].events & (EPOLLERR | EPOLLHUP))
+				flags |= CURL_CSELECT_ERR;
+			curl_multi_socket_action(multiHandle, events[i].data.fd, flags, &runningHandles);
+		}
+
+		// Checked on every pass, not just when epoll_wait times out, so that with many busy sockets
+		// curl's timers (connect and DNS timeouts, retries) still run on time
+		if (timerSet && std::chrono::steady_clock::now() >= timerDeadline)
+		{
+			timerSet = false;// curl sets a new one from within the call if it needs to
+			curl_multi_socket_action(multiHandle, CURL_SOCKET_TIMEOUT, 0, &runningHandles);
+		}
+
+		ProcessCompletedTransfers();
+	}
+
+	return true;
+}
+
+#else
+
+bool AsyncCurl::Run()
+{
+	int runningHandles;
+	while (!activeRequests.empty())
+	{
+		CURLMcode result(curl_multi_perform(multiHandle, &runningHandles));
+		if (result == CURLM_OK && runningHandles > 0)
+			result = curl_multi_poll(multiHandle, nullptr, 0, 1000, nullptr);
+
+		if (result != CURLM_OK)
+		{
+			log << "Failed to process transfers:  " << curl_multi_strerror(result) << std::endl;
+			AbandonTransfers();
+			return false;
+		}
+
+		ProcessCompletedTransfers();
+	}
+
+	return true;
+}
+
+#endif// _WIN32
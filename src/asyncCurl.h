@@ -0,0 +1,161 @@
+// File:  asyncCurl.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Single-threaded asynchronous HTTP layer built on the curl multi interface.
+//        Requests are exposed as awaitables so many transfers can be in flight at
+//        once from C++20 coroutines without one thread per request.
+
+#ifndef ASYNC_CURL_H_
+#define ASYNC_CURL_H_
+
+// Local headers
+#include "utilities/uString.h"
+
+// cURL headers
+#include <curl/curl.h>
+
+// Standard C++ headers
+#include <coroutine>
+#include <functional>
+#include <exception>
+#include <utility>
+#include <string>
+#include <unordered_set>
+#include <chrono>
+
+// Lazily-started coroutine returning a value of type T.  Awaiting a Task starts it and
+// resumes the awaiting coroutine when it completes; top-level tasks are started with
+// Start() and their result collected with Result() once the event loop has drained.
+template<typename T>
+class Task
+{
+public:
+	struct promise_type
+	{
+		T value{};
+		std::coroutine_handle<> continuation;
+
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+
+		struct FinalAwaiter
+		{
+			bool await_ready() noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+			{
+				if (h.promise().continuation)
+					return h.promise().continuation;
+				return std::noop_coroutine();
+			}
+			void await_resume() noexcept {}
+		};
+
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void return_value(T v) { value = std::move(v); }
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	Task(Task&& t) noexcept : handle(std::exchange(t.handle, nullptr)) {}
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+	~Task()
+	{
+		if (handle)
+			handle.destroy();
+	}
+
+	void Start() { handle.resume(); }
+	bool IsDone() const { return handle.done(); }
+	T& Result() { return handle.promise().value; }
+
+	bool await_ready() const noexcept { return false; }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+	{
+		handle.promise().continuation = awaiting;
+		return handle;
+	}
+	T await_resume() { return std::move(handle.promise().value); }
+
+private:
+	explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+	std::coroutine_handle<promise_type> handle;
+};
+
+class AsyncCurl
+{
+public:
+	explicit AsyncCurl(UString::OStream& log = Cout);
+	~AsyncCurl();
+
+	AsyncCurl(const AsyncCurl&) = delete;
+	AsyncCurl& operator=(const AsyncCurl&) = delete;
+
+	void SetCACertificatePath(const UString::String& path) { caCertificatePath = path; }
+	void SetVerboseOutput(const bool& verboseOutput = true) { verbose = verboseOutput; }
+
+	struct Response
+	{
+		bool ok = false;// True if the transfer completed (says nothing about the HTTP status)
+		long httpCode = 0;
+		std::string body;
+	};
+
+	// Called after the standard options are applied to allow callers to add headers, etc.
+	typedef std::function<bool(CURL*)> CurlModification;
+
+	class Request
+	{
+	public:
+		bool await_ready() const noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> h);
+		Response await_resume() { return std::move(response); }
+
+	private:
+		friend class AsyncCurl;
+		Request(AsyncCurl& loop, const UString::String& url, const std::string* postData, CurlModification modification);
+
+		AsyncCurl& loop;
+		const std::string url;
+		const bool isPost;
+		const std::string postData;
+		const CurlModification modification;
+
+		CURL* curl = nullptr;
+		std::coroutine_handle<> waiter;
+		Response response;
+	};
+
+	Request Get(const UString::String& url, CurlModification modification = nullptr);
+	Request Post(const UString::String& url, const std::string& data, CurlModification modification = nullptr);
+
+	// Drives all outstanding transfers to completion, resuming waiting coroutines as they finish.  On failure,
+	// any transfers still in flight are abandoned (their coroutines are left suspended).
+	bool Run();
+
+private:
+	UString::OStream& log;
+	UString::String caCertificatePath;
+	bool verbose = false;
+
+	CURLM* multiHandle;
+	std::unordered_set<Request*> activeRequests;
+
+#ifndef _WIN32
+	int epollFD;
+	bool timerSet = false;// When curl has asked to be called back at timerDeadline
+	std::chrono::steady_clock::time_point timerDeadline;
+	std::unordered_set<curl_socket_t> watchedSockets;
+
+	static int SocketCallback(CURL* curl, curl_socket_t s, int what, void* userp, void* socketp);
+	static int TimerCallback(CURLM* multi, long timeoutMS, void* userp);
+#endif// _WIN32
+
+	static CURLM* CreateMultiHandle();
+	bool StartTransfer(Request& request);
+	void ProcessCompletedTransfers();
+	void AbandonTransfers();
+
+	static size_t WriteCallback(char* ptr, size_t size, size_t nmemb, void* userData);
+};
+
+#endif// ASYNC_CURL_H_
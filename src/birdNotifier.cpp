@@ -6,105 +6,573 @@
 // Local headers
 #include "birdNotifier.h"
 #include "email/oAuth2Interface.h"
+#include "fileNotificationStore.h"
+#include "shardMap.h"
+#include "notificationDispatcher.h"
+#include "emailTransport.h"
+#include "webhookTransport.h"
+#include "fileTransport.h"
+#include "startupProfiler.h"
 
 // Standard C++ headers
 #include <iostream>
 #include <sstream>
-#include <filesystem>
 #include <iomanip>
 #include <cassert>
+#include <deque>
+#include <unordered_set>
+#include <unordered_map>
+#include <limits>
+#include <string_view>
+#include <iterator>
+#include <thread>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <atomic>
 
-#ifdef _WIN32
-	namespace fs = std::experimental::filesystem;
-#else
-	namespace fs = std::filesystem;
-#endif// _WIN32
+void BirdNotifier::UpdateConfiguration(std::shared_ptr<const BirdNotifierConfig> newConfig)
+{
+	nextConfig.store(std::move(newConfig));
+}
 
 bool BirdNotifier::Run()
 {
-	log << "Reading previously processed observations..." << std::endl;
-	std::vector<ReportedObservation> previouslyProcessedObservations;
-	if (!ReadPreviousObservations(previouslyProcessedObservations))
+	config = nextConfig.load();// Snapshot is held for the whole cycle, so a concurrent update never affects a poll in progress
+	const bool success(Poll());
+	arena.Release();// Everything allocated from the arena during this cycle goes away at once
+	return success;
+}
+
+bool BirdNotifier::Poll()
+{
+	FileNotificationStore store(config->alreadyNotifiedFile, log);
+	store.SetCompression(config->compressHistory);
+	std::vector<WatchConfig> watches;
+	if (!SelectWatches(store, watches))
 		return false;
 
+	// Nothing new can have shown up on a watch we've only just checked, so skip the request (and, if that's all of them, everything else)
+	if (config->fetchCacheTime > 0)
+	{
+		RemoveRecentlyFetched(store, watches);
+		if (watches.empty())
+		{
+			log << "All watches were checked within the last " << config->fetchCacheTime << " min; nothing to do" << std::endl;
+			return true;
+		}
+	}
+
 	log << "Checking for recent observations..." << std::endl;
-	EBirdInterface ebi(UString::ToStringType(config.eBirdAPIKey), log);
+	const int64_t fetchTime(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
 	std::vector<EBirdInterface::ObservationInfo> observations;
-	if (!ebi.GetRecentNotableObservations(UString::ToStringType(config.regionCode), config.daysBack, observations))
+	std::vector<size_t> failedWatches;
+	if (!GetRecentObservations(watches, observations, failedWatches))
 		return false;
 
+	// Whatever did come back is still processed; failed watches are just tried again next cycle
+	for (auto i = failedWatches.rbegin(); i != failedWatches.rend(); ++i)
+		watches.erase(watches.begin() + *i);
+
 	// For some reason, the eBird list of notable sightings tends to include multiple instances of same observation
-	observations.erase(std::unique(observations.begin(), observations.end()), observations.end());
+	// (and overlapping watches will return the same observation more than once)
+	RemoveDuplicates(observations, arena.Resource());
 
 	log << "Tailoring observation list..." << std::endl;
-	ExcludeSpecies(observations, config.excludeSpecies);
-	ExcludeObservations(observations, previouslyProcessedObservations);
-	log << "There are " << observations.size() << " new observations" << std::endl;
+	ExcludeSpecies(observations, config->excludeSpecies);
+	PublishSnapshot(observations);
 
-	if (!observations.empty())
+	// When the store is shared, hold the lock from reading the processed list until it has been rewritten
+	// so that two workers with overlapping watches (or a worker taking over for a failed one) can't both notify
+	if (IsSharded() && !LockStore(store))
+		return false;
+
+	const bool success(ProcessNewObservations(store, observations));
+	if (success && config->fetchCacheTime > 0)
+		RecordFetchTimes(store, watches, fetchTime);
+
+	if (IsSharded())
+		store.Unlock(config->workerID);
+
+	if (!failedWatches.empty())
 	{
-		log << "Sending notifications..." << std::endl;
-		if (!SendNotification(observations))
+		log << failedWatches.size() << " of " << failedWatches.size() + watches.size() << " watches could not be checked this cycle" << std::endl;
+		return false;
+	}
+
+	return success;
+}
+
+bool BirdNotifier::Replay(const std::string& responseDirectory, const std::string& outputDirectory)
+{
+	config = nextConfig.load();
+	const auto start(std::chrono::steady_clock::now());
+
+	std::vector<std::filesystem::path> responseFiles;
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::directory_iterator(responseDirectory, ec))
+	{
+		if (entry.is_regular_file() && entry.path().extension() != ".tmp")// Skip anything still being archived
+			responseFiles.push_back(entry.path());
+	}
+
+	if (ec)
+	{
+		log << "Failed to read '" << UString::ToStringType(responseDirectory) << "':  " << UString::ToStringType(ec.message()) << std::endl;
+		return false;
+	}
+	std::sort(responseFiles.begin(), responseFiles.end());
+
+	std::filesystem::create_directories(outputDirectory, ec);
+	if (ec)
+	{
+		log << "Failed to create '" << UString::ToStringType(outputDirectory) << "':  " << UString::ToStringType(ec.message()) << std::endl;
+		return false;
+	}
+
+	std::optional<TaxonomyCache> taxonomy;
+	if (NeedsTaxonomy())
+	{
+		EBirdInterface ebi(CreateEBirdInterface());
+		taxonomy.emplace(log);
+		if (!taxonomy->Load(config->taxonomyFile, config->taxonomyMaxAge, ebi))
+			return false;
+	}
+
+	// Decoding and filtering depend only on the response itself, so each file is processed independently.
+	// Each worker parses without an arena, since the cJSON hooks the arena relies on are global.
+	log << "Replaying " << responseFiles.size() << " responses..." << std::endl;
+	std::vector<std::vector<EBirdInterface::ObservationInfo>> observations(responseFiles.size());
+	std::vector<char> decoded(responseFiles.size(), 0);
+	ForEachInParallel(responseFiles.size(), [&](const size_t& i, UString::OStream& workerLog)
+	{
+		std::string response;
+		EBirdInterface ebi(UString::String(), workerLog);
+		if (!ResponseArchive::Load(responseFiles[i].string(), response) || !ebi.ParseRecentNotableObservations(response, observations[i]))
+		{
+			workerLog << "Failed to decode '" << UString::ToStringType(responseFiles[i].string()) << "'" << std::endl;
+			return;
+		}
+
+		RemoveDuplicates(observations[i], std::pmr::new_delete_resource());
+		ExcludeSpecies(observations[i], config->excludeSpecies);
+		if (taxonomy)
+			ExcludeTaxa(observations[i], *taxonomy, config->excludeFamilies, config->excludeOrders);
+		decoded[i] = 1;
+	}, log);
+
+	// What counts as already notified depends on every earlier response, so this part is done in order
+	std::unordered_map<std::string, uint64_t> notified;// Value is the fingerprint
+	std::optional<EventClusterer> clusterer;
+	if (config->clusterEvents)
+		clusterer.emplace(config->clusterDistance, std::chrono::hours(config->clusterWindow * 24), std::vector<EventClusterer::Event>());
+
+	for (auto& o : observations)
+	{
+		o.erase(std::remove_if(o.begin(), o.end(), [this, &notified](EBirdInterface::ObservationInfo& info)
+		{
+			const auto it(notified.find(UString::ToNarrowString(info.observationID)));
+			if (it == notified.end())
+				return false;
+
+			info.isUpdate = config->notifyUpdates && it->second != info.Fingerprint();
+			return !info.isUpdate;
+		}), o.end());
+
+		for (const auto& info : o)
+			notified[UString::ToNarrowString(info.observationID)] = info.Fingerprint();
+
+		if (clusterer && !o.empty())
+			o = clusterer->Process(o);
+		if (taxonomy && config->taxonomicSort)
+			SortTaxonomically(o, *taxonomy);
+	}
+
+	std::atomic<unsigned int> written(0);
+	std::atomic<bool> writeFailed(false);
+	ForEachInParallel(responseFiles.size(), [&](const size_t& i, UString::OStream& workerLog)
+	{
+		if (observations[i].empty())
+			return;
+
+		auto fileName(std::filesystem::path(outputDirectory) / responseFiles[i].filename());
+		if (fileName.extension() == ".z")// Archived responses
+			fileName.replace_extension();
+		fileName.replace_extension(".html");
+		std::ofstream file(fileName, std::ios::binary);
+		if (!file.is_open() || !(file << BuildMessageBody(observations[i], true)))
+		{
+			workerLog << "Failed to write '" << UString::ToStringType(fileName.string()) << "'" << std::endl;
+			writeFailed = true;
+			return;
+		}
+		++written;
+	}, log);
+
+	const std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+	const auto decodedCount(std::count(decoded.begin(), decoded.end(), 1));
+	log << "Replayed " << decodedCount << " of " << responseFiles.size() << " responses in " << elapsed.count() << " sec ("
+		<< decodedCount / std::max(elapsed.count(), 1e-6) << " per sec); " << written << " would have sent notifications" << std::endl;
+
+	return decodedCount == static_cast<std::ptrdiff_t>(responseFiles.size()) && !writeFailed;
+}
+
+void BirdNotifier::ForEachInParallel(const size_t& count, const std::function<void(const size_t&, UString::OStream&)>& work, UString::OStream& log)
+{
+	const unsigned int threadCount(std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned int>(count))));
+	std::atomic<size_t> next(0);
+	std::vector<UString::OStringStream> threadLogs(threadCount);
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for (size_t i = next++; i < count; i = next++)
+				work(i, threadLogs[t]);
+		});
+	}
+
+	for (unsigned int t = 0; t < threadCount; ++t)
+	{
+		threads[t].join();
+		log << threadLogs[t].str();
+	}
+}
+
+void BirdNotifier::PublishSnapshot(const std::vector<EBirdInterface::ObservationInfo>& observations)
+{
+	auto newSnapshot(std::make_shared<ObservationSnapshot>());
+	newSnapshot->published = std::chrono::system_clock::now();
+	newSnapshot->cycle = ++cycle;
+	newSnapshot->observations = observations;
+	snapshot.store(std::move(newSnapshot));
+}
+
+bool BirdNotifier::ProcessNewObservations(NotificationStore& store, std::vector<EBirdInterface::ObservationInfo>& observations)
+{
+	if (observations.empty())
+	{
+		log << "There are no new or updated observations" << std::endl;
+		return SendNotification(store, observations);// Still retry anything a transport failed to deliver earlier
+	}
+
+	// The filter stands in for the history, which is only read in full (and rewritten without expired records)
+	// when the filter needs rebuilding.  Otherwise only the records for what might already be in it are read.
+	BloomFilter filter;
+	const bool rebuild(!store.ReadFilter(filter) || FilterNeedsRebuild(filter));
+
+	std::vector<ReportedObservation> previouslyProcessedObservations;
+	if (rebuild)
+	{
+		log << "Reading previously processed observations..." << std::endl;
+		if (!store.Read(previouslyProcessedObservations))
 			return false;
 	}
+	else
+	{
+		const auto candidates(GetPossiblyProcessedIDs(observations, filter));
+		if (!candidates.empty() && !store.Read(candidates, previouslyProcessedObservations))
+			return false;
+
+		// Expired records stay in the history (and the filter) until the next rebuild, but no longer count
+		RemoveExpiredObservations(previouslyProcessedObservations);
+	}
+	std::vector<ReportedObservation> fingerprintedObservations;
+	ExcludeObservations(observations, previouslyProcessedObservations, config->notifyUpdates, arena.Resource(), fingerprintedObservations);
+
+	if (NeedsTaxonomy() && !observations.empty())
+	{
+		EBirdInterface ebi(CreateEBirdInterface());
+		TaxonomyCache taxonomy(log);
+		if (!taxonomy.Load(config->taxonomyFile, config->taxonomyMaxAge, ebi))
+			return false;
+
+		ExcludeTaxa(observations, taxonomy, config->excludeFamilies, config->excludeOrders);
+		if (config->taxonomicSort)
+			SortTaxonomically(observations, taxonomy);
+	}
+	log << "There are " << observations.size() << " new or updated observations" << std::endl;
+
+	// Everything new goes into the history, but repeat reports of the same bird are only notified when something changes
+	std::vector<EBirdInterface::ObservationInfo> clustered;
+	std::optional<std::vector<EventClusterer::Event>> updatedEvents;// Saved with the history, once notifications have gone out
+	if (config->clusterEvents && !observations.empty())
+	{
+		std::vector<EventClusterer::Event> events;
+		if (!store.ReadEvents(events))
+			return false;
+
+		EventClusterer clusterer(config->clusterDistance, std::chrono::hours(config->clusterWindow * 24), std::move(events));
+		clustered = clusterer.Process(observations);
+		log << "Observations represent " << clustered.size() << " new or changed events" << std::endl;
+
+		const auto expireBefore(std::chrono::system_clock::now() - std::chrono::hours((config->daysBack + config->clusterWindow) * 24));
+		updatedEvents = clusterer.GetEvents(std::chrono::system_clock::to_time_t(expireBefore));
+	}
+	const auto& toNotify(config->clusterEvents ? clustered : observations);
+
+	// Renew the lease so it can't expire (letting another worker in) while we're sending
+	if (IsSharded() && !store.TryLock(config->workerID, std::chrono::seconds(config->workerLease)))
+	{
+		log << "Lost notification store lock; not sending" << std::endl;
+		return false;
+	}
+
+	// Anything a transport fails to deliver is kept for it to try again, so (unless that can't be saved) the
+	// observations count as processed either way, and the transports that did deliver don't send them twice
+	if (!SendNotification(store, toNotify))
+		return false;
+
+	if (updatedEvents && !store.WriteEvents(*updatedEvents))
+		return false;
 
 	log << "Updating list of previously processed observations..." << std::endl;
-	UpdateProcessedObservations(previouslyProcessedObservations, observations);
-	if (!WritePreviousObservations(previouslyProcessedObservations))
+	if (rebuild)
+	{
+		UpdateProcessedObservations(previouslyProcessedObservations, observations);
+		if (!store.Write(previouslyProcessedObservations))
+			return false;
+
+		store.WriteFilter(BuildFilter(previouslyProcessedObservations));// Not fatal if this fails; next cycle just loads the history
+		return true;
+	}
+
+	// Add to the history without reading the rest of it; records for updated (or newly fingerprinted) observations supersede the old ones
+	std::vector<ReportedObservation> newlyProcessedObservations(std::move(fingerprintedObservations));
+	newlyProcessedObservations.reserve(newlyProcessedObservations.size() + observations.size());
+	for (const auto& o : observations)
+	{
+		newlyProcessedObservations.push_back(MakeReportedObservation(o));
+		filter.Add(newlyProcessedObservations.back().observationId);
+	}
+
+	if (newlyProcessedObservations.empty())
+		return true;
+
+	if (!store.Append(newlyProcessedObservations))
 		return false;
 
+	store.WriteFilter(filter);
 	return true;
 }
 
-bool BirdNotifier::ReadPreviousObservations(std::vector<ReportedObservation>& observations)
+bool BirdNotifier::FilterNeedsRebuild(const BloomFilter& filter)
 {
-	if (config.alreadyNotifiedFile.empty())
-		return true;
+	return filter.IsFull() || std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()) >= filter.GetCompactAfter();
+}
 
-	// If the file doesn't exist, don't treat is as an error because it wouldn't have been written yet on first execution of the application
-	if (!fs::exists(config.alreadyNotifiedFile))
-		return true;
+std::unordered_set<std::string> BirdNotifier::GetPossiblyProcessedIDs(const std::vector<EBirdInterface::ObservationInfo>& observations, const BloomFilter& filter)
+{
+	std::unordered_set<std::string> ids;
+	for (const auto& o : observations)
+	{
+		for (const auto& key : { o.observationID, o.legacyObservationID })
+		{
+			auto id(UString::ToNarrowString(key));
+			if (!id.empty() && filter.MightContain(id))
+				ids.insert(std::move(id));
+		}
+	}
+	return ids;
+}
 
-	std::ifstream file(config.alreadyNotifiedFile);
-	if (!file.is_open())
+BloomFilter BirdNotifier::BuildFilter(const std::vector<ReportedObservation>& observations) const
+{
+	constexpr uint32_t minimumCapacity(1024);
+	BloomFilter filter(std::max(minimumCapacity, static_cast<uint32_t>(2 * observations.size())));// Leave room to grow before the next rebuild
+	for (const auto& o : observations)
+		filter.Add(o.observationId);
+
+	// By then, everything in the history now has expired; rebuilding sooner (e.g. when the oldest record expires,
+	// which is almost immediately) would mean reading and rewriting the whole history nearly every cycle
+	filter.SetCompactAfter(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() + std::chrono::hours(config->daysBack * 24)));
+	return filter;
+}
+
+bool BirdNotifier::SelectWatches(NotificationStore& store, std::vector<WatchConfig>& watches)
+{
+	if (!IsSharded())
 	{
-		log << "Failed to open '" << UString::ToStringType(config.alreadyNotifiedFile) << "' for input\n";
+		watches = config->watches;
+		return true;
+	}
+
+	if (!store.Heartbeat(config->workerID))
 		return false;
+
+	std::vector<std::string> workers;
+	if (!store.GetLiveWorkers(std::chrono::seconds(config->workerLease), workers))
+		return false;
+
+	if (std::find(workers.begin(), workers.end(), config->workerID) == workers.end())
+		workers.push_back(config->workerID);
+
+	const ShardMap shards(workers);
+	for (const auto& w : config->watches)
+	{
+		if (shards.GetOwner(GetWatchKey(w)) == config->workerID)
+			watches.push_back(w);
 	}
 
-	std::string line;
-	while (std::getline(file, line))
+	log << "Worker " << UString::ToStringType(config->workerID) << " is responsible for " << watches.size()
+		<< " of " << config->watches.size() << " watches (" << workers.size() << " live workers)" << std::endl;
+	return true;
+}
+
+bool BirdNotifier::LockStore(NotificationStore& store)
+{
+	// Other workers hold the lock only briefly, so it's worth waiting for; give up if it looks stuck
+	const auto giveUp(std::chrono::steady_clock::now() + std::chrono::seconds(config->workerLease));
+	while (!store.TryLock(config->workerID, std::chrono::seconds(config->workerLease)))
 	{
-		ReportedObservation o;
-		if (!ParseReportedObservationLine(line, o))
+		if (std::chrono::steady_clock::now() > giveUp)
+		{
+			log << "Timed out waiting for notification store lock" << std::endl;
 			return false;
-		observations.push_back(o);
+		}
+
+		std::this_thread::sleep_for(std::chrono::seconds(1));
 	}
 
 	return true;
 }
 
-bool BirdNotifier::ParseReportedObservationLine(const std::string& line, ReportedObservation& o)
+void BirdNotifier::RemoveRecentlyFetched(NotificationStore& store, std::vector<WatchConfig>& watches) const
 {
-	std::istringstream ss(line);
-	if (!std::getline(ss, o.observationId, ','))
+	std::unordered_map<std::string, int64_t> fetchTimes;
+	store.ReadFetchTimes(fetchTimes);// Not fatal; everything is fetched
+
+	const int64_t fetchedAfter(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - std::chrono::minutes(config->fetchCacheTime)));
+	watches.erase(std::remove_if(watches.begin(), watches.end(), [&fetchTimes, &fetchedAfter](const WatchConfig& w)
 	{
-		log << "Failed to parse ID from observation line\n";
+		const auto it(fetchTimes.find(GetWatchKey(w)));
+		return it != fetchTimes.end() && it->second > fetchedAfter;
+	}), watches.end());
+}
+
+void BirdNotifier::RecordFetchTimes(NotificationStore& store, const std::vector<WatchConfig>& watches, const int64_t& fetchTime) const
+{
+	// Re-read so times recorded by other workers since we checked are kept
+	std::unordered_map<std::string, int64_t> fetchTimes;
+	store.ReadFetchTimes(fetchTimes);
+
+	const int64_t fetchedAfter(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - std::chrono::minutes(config->fetchCacheTime)));
+	std::erase_if(fetchTimes, [&fetchedAfter](const auto& t) { return t.second <= fetchedAfter; });
+	for (const auto& w : watches)
+		fetchTimes[GetWatchKey(w)] = fetchTime;
+
+	store.WriteFetchTimes(fetchTimes);// Not fatal; next cycle just fetches again
+}
+
+std::string BirdNotifier::GetWatchKey(const WatchConfig& w)
+{
+	std::ostringstream ss;
+	if (w.regionCode.empty())
+		ss << w.latitude << ',' << w.longitude << ',' << w.radius;
+	else
+		ss << w.regionCode;
+
+	for (const auto& species : w.speciesCodes)
+		ss << ':' << species;
+	return ss.str();
+}
+
+EBirdInterface BirdNotifier::CreateEBirdInterface() const
+{
+	EBirdInterface ebi(UString::ToStringType(config->eBirdAPIKey), log);
+	if (!config->eBirdAPIRoot.empty())
+		ebi.SetAPIRoot(UString::ToStringType(config->eBirdAPIRoot));
+	return ebi;
+}
+
+bool BirdNotifier::GetRecentObservations(const std::vector<WatchConfig>& watches, std::vector<EBirdInterface::ObservationInfo>& observations, std::vector<size_t>& failedWatches)
+{
+	EBirdInterface ebi(CreateEBirdInterface());
+	ebi.SetArena(useArenaForParsing ? &arena : nullptr);
+	std::optional<ResponseArchive> archive;
+	if (!config->responseArchive.empty())
+	{
+		archive.emplace(config->responseArchive, log);
+		ebi.SetResponseArchive(&*archive);
+	}
+	AsyncCurl loop(log);
+
+	// All requests are issued concurrently on this thread; each task fills its own list (deque so references remain valid as it grows)
+	std::deque<std::vector<EBirdInterface::ObservationInfo>> requestObservations;
+	std::vector<Task<bool>> requests;
+	std::vector<UString::String> requestDescriptions;
+	std::vector<size_t> requestWatches;
+	size_t watchIndex(0);
+	auto addRequest([&](Task<bool>&& t, const UString::String& description)
+	{
+		requests.push_back(std::move(t));
+		requestDescriptions.push_back(description);
+		requestWatches.push_back(watchIndex);
+		requests.back().Start();
+	});
+
+	// Let the server do the filtering where possible:  species watches request only those species and point watches only the surrounding area
+	for (; watchIndex < watches.size(); ++watchIndex)
+	{
+		const auto& w(watches[watchIndex]);
+		const auto region(UString::ToStringType(w.regionCode));
+		UString::OStringStream point;
+		point << w.latitude << ',' << w.longitude << " (" << w.radius << " km)";
+
+		if (w.speciesCodes.empty())
+		{
+			requestObservations.emplace_back();
+			if (w.regionCode.empty())
+				addRequest(ebi.GetRecentNotableObservationsAsync(loop, w.latitude, w.longitude, w.radius, config->daysBack, requestObservations.back()), point.str());
+			else
+				addRequest(ebi.GetRecentNotableObservationsAsync(loop, region, config->daysBack, requestObservations.back()), region);
+			continue;
+		}
+
+		for (const auto& species : w.speciesCodes)
+		{
+			requestObservations.emplace_back();
+			const auto speciesCode(UString::ToStringType(species));
+			if (w.regionCode.empty())
+				addRequest(ebi.GetRecentSpeciesObservationsAsync(loop, w.latitude, w.longitude, w.radius, speciesCode, config->daysBack, requestObservations.back()), point.str() + _T(" : ") + speciesCode);
+			else
+				addRequest(ebi.GetRecentSpeciesObservationsAsync(loop, region, speciesCode, config->daysBack, requestObservations.back()), region + _T(" : ") + speciesCode);
+		}
+	}
+
+	StartupProfiler::Mark("first request");
+	if (!loop.Run())
 		return false;
+	StartupProfiler::Mark("observations received");
+
+	// One failed request (e.g. rate limited) only costs that request's results
+	unsigned int failedRequests(0);
+	for (unsigned int i = 0; i < requests.size(); ++i)
+	{
+		if (!requests[i].IsDone() || !requests[i].Result())
+		{
+			log << "Failed to get observations for " << requestDescriptions[i] << std::endl;
+			if (failedWatches.empty() || failedWatches.back() != requestWatches[i])
+				failedWatches.push_back(requestWatches[i]);
+			++failedRequests;
+			continue;
+		}
+
+		observations.insert(observations.end(), std::make_move_iterator(requestObservations[i].begin()), std::make_move_iterator(requestObservations[i].end()));
 	}
 
-	if (!std::getline(ss, o.observationDate, ','))
+	if (failedRequests == requests.size() && !requests.empty())
 	{
-		log << "Failed to parse date from observation line\n";
+		log << "All requests failed" << std::endl;
 		return false;
 	}
 
 	return true;
 }
 
-void BirdNotifier::UpdateProcessedObservations(std::vector<ReportedObservation>& processedObservations, const std::vector<EBirdInterface::ObservationInfo>& observations)
+void BirdNotifier::RemoveExpiredObservations(std::vector<ReportedObservation>& processedObservations) const
 {
-	const auto removeBefore(std::chrono::system_clock::now() - std::chrono::hours(config.daysBack * 24));
+	const auto removeBefore(std::chrono::system_clock::now() - std::chrono::hours(config->daysBack * 24));
 	auto isOldEnoughToRemove([&removeBefore](const ReportedObservation& ro)
 	{
 		std::chrono::system_clock::time_point tp;
@@ -113,16 +581,54 @@ void BirdNotifier::UpdateProcessedObservations(std::vector<ReportedObservation>&
 		return tp < removeBefore;
 	});
 	processedObservations.erase(std::remove_if(processedObservations.begin(), processedObservations.end(), isOldEnoughToRemove), processedObservations.end());
+}
+
+void BirdNotifier::UpdateProcessedObservations(std::vector<ReportedObservation>& processedObservations, const std::vector<EBirdInterface::ObservationInfo>& observations)
+{
+	RemoveExpiredObservations(processedObservations);
+
+	// Updated observations are already in the list; just record the new fingerprint
+	std::unordered_map<std::string, uint64_t> updates;
+	for (const auto& o : observations)
+	{
+		if (!o.isUpdate)
+			continue;
 
+		updates.emplace(UString::ToNarrowString(o.observationID), o.Fingerprint());
+		if (!o.legacyObservationID.empty())// The record may predate the current key
+			updates.emplace(UString::ToNarrowString(o.legacyObservationID), o.Fingerprint());
+	}
+
+	if (!updates.empty())
+	{
+		for (auto& ro : processedObservations)
+		{
+			const auto update(updates.find(ro.observationId));
+			if (update != updates.end())
+				ro.fingerprint = update->second;
+		}
+	}
+
+	processedObservations.reserve(processedObservations.size() + observations.size() - updates.size());
 	for (const auto& newO : observations)
 	{
-		ReportedObservation ro;
-		ro.observationId = UString::ToNarrowString(newO.observationID);
-		ro.observationDate = UString::ToNarrowString(BuildTimeString(newO.observationDate, newO.dateIncludesTimeInfo));
-		processedObservations.push_back(ro);
+		if (!newO.isUpdate)
+			processedObservations.push_back(MakeReportedObservation(newO));
 	}
 }
 
+BirdNotifier::ReportedObservation BirdNotifier::MakeReportedObservation(const EBirdInterface::ObservationInfo& o)
+{
+	UString::OStringStream ss;
+	WriteTimeString(ss, o.observationDate, o.dateIncludesTimeInfo);
+
+	ReportedObservation ro;
+	ro.observationId = UString::ToNarrowString(o.observationID);
+	ro.observationDate = UString::ToNarrowString(ss.str());
+	ro.fingerprint = o.Fingerprint();
+	return ro;
+}
+
 bool BirdNotifier::DateStringToTimePoint(const std::string& s, std::chrono::system_clock::time_point& tp)
 {
 	// Format is expected to be: %m/%D/%Y %H:%M
@@ -166,64 +672,151 @@ bool BirdNotifier::ExtractAndParseDateToken(std::istringstream& ss, const char&
 	return true;
 }
 
-bool BirdNotifier::WritePreviousObservations(const std::vector<ReportedObservation>& observations)
+bool BirdNotifier::SendNotification(NotificationStore& store, const std::vector<EBirdInterface::ObservationInfo>& observations)
 {
-	if (config.alreadyNotifiedFile.empty())
+	std::vector<NotificationDispatcher::Delivery> deliveries;
+	if (!store.ReadPendingDeliveries(deliveries))
+		return false;
+
+	if (deliveries.empty() && observations.empty())
 		return true;
 
-	std::ofstream file(config.alreadyNotifiedFile);
-	if (!file.is_open())
+	if (sendPreparation && !sendPreparation(*config))
+		return false;
+
+	NotificationDispatcher dispatcher(config->deliveryAttempts, log);
+	AddTransports(dispatcher);
+	const auto transports(dispatcher.GetTransportNames());
+
+	// Give up on anything owed by a transport that has since been removed, or for longer than the sightings themselves are tracked
+	const int64_t now(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+	const int64_t expireBefore(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - std::chrono::hours(config->daysBack * 24)));
+	const auto pendingCount(deliveries.size());
+	std::erase_if(deliveries, [this, &transports, &expireBefore](const NotificationDispatcher::Delivery& d)
 	{
-		log << "Failed to open '" << UString::ToStringType(config.alreadyNotifiedFile) << "' for output\n";
+		if (std::find(transports.begin(), transports.end(), d.transport) == transports.end())
+		{
+			log << "Discarding undelivered notification for removed transport " << UString::ToStringType(d.transport) << std::endl;
+			return true;
+		}
+
+		if (d.queued < expireBefore)
+		{
+			log << "Giving up on delivering notification via " << UString::ToStringType(d.transport) << std::endl;
+			return true;
+		}
 		return false;
+	});
+
+	if (!deliveries.empty())
+		log << "Retrying " << deliveries.size() << " undelivered notification(s)..." << std::endl;
+
+	if (!observations.empty())
+	{
+		log << "Sending notifications..." << std::endl;
+		NotificationTransport::Message message;
+		message.subject = "birdNotifier Message";
+		message.htmlBody = BuildMessageBody(observations, true);
+		message.textBody = BuildMessageBody(observations, false);
+		for (const auto& t : transports)
+			deliveries.push_back(NotificationDispatcher::Delivery{ t, now, message });
 	}
 
-	for (const auto& o : observations)
-		file << o.observationId << "," << o.observationDate << '\n';
+	const auto undelivered(dispatcher.Deliver(deliveries));
+	if (undelivered.empty() && pendingCount == 0)
+		return true;
 
-	return true;
-}
+	if (!store.WritePendingDeliveries(undelivered))
+	{
+		log << "Failed to save undelivered notifications" << std::endl;
+		return false;
+	}
 
-bool BirdNotifier::SendNotification(const std::vector<EBirdInterface::ObservationInfo>& observations)
-{
-	EmailSender::LoginInfo loginInfo;
-	std::vector<EmailSender::AddressInfo> recipients;
-	BuildEmailEssentials(loginInfo, recipients);
-	constexpr bool verbose(false);
-	EmailSender sender("birdNotifier Message", BuildMessageBody(observations), std::string(), recipients, loginInfo, true, verbose, log);
-	return sender.SendREST();
+	return true;
 }
 
-std::string BirdNotifier::BuildMessageBody(const std::vector<EBirdInterface::ObservationInfo>& observations)
+std::string BirdNotifier::BuildMessageBody(const std::vector<EBirdInterface::ObservationInfo>& observations, const bool& html)
 {
 	UString::OStringStream ss;
 	for (const auto& o : observations)
 	{
-		ss << "<p><b>" << o.commonName << "</b> (";
+		if (html)
+			ss << "<p>";
+		if (o.isUpdate)
+			ss << (html ? "<i>Updated:</i> " : "Updated: ");
+		if (html)
+			ss << "<b>" << o.commonName << "</b> (";
+		else
+			ss << o.commonName << " (";
 		if (o.presenceNoted)
 			ss << "X";
 		else
 			ss << o.count;
-		ss << "), " << BuildTimeString(o.observationDate, o.dateIncludesTimeInfo) << ", " << o.locationName << ", " << o.userName << " -- https://ebird.org/checklist/" << o.checklistID << "</p>";
+		ss << "), ";
+		if (o.reportCount > 1)
+			ss << o.reportCount << " reports, latest ";
+		WriteTimeString(ss, o.observationDate, o.dateIncludesTimeInfo);
+		ss << ", " << o.locationName;
+		if (!o.userName.empty())// Not available from all endpoints
+			ss << ", " << o.userName;
+		ss << " -- https://ebird.org/checklist/" << o.checklistID;
+		if (html)
+			ss << "</p>";
+		else
+			ss << '\n';
 	}
 
 	return UString::ToNarrowString(ss.str());
 }
 
-void BirdNotifier::BuildEmailEssentials(EmailSender::LoginInfo& loginInfo, std::vector<EmailSender::AddressInfo>& recipients)
+void BirdNotifier::AddTransports(NotificationDispatcher& dispatcher) const
 {
-	loginInfo.smtpUrl = std::string("https://gmail.googleapis.com/gmail/v1/users/me/messages/send?alt=json");
-	loginInfo.localEmail = config.emailInfo.sender;
-	loginInfo.oAuth2Token = UString::ToNarrowString(OAuth2Interface::Get().GetRefreshToken());
+	std::vector<EmailSender::AddressInfo> recipients(config->emailInfo.recipients.size());
+	for (unsigned int i = 0; i < recipients.size(); ++i)
+	{
+		recipients[i].address = config->emailInfo.recipients[i];
+		recipients[i].displayName = config->emailInfo.recipients[i];
+	}
+
+	EmailSender::LoginInfo loginInfo;
+	loginInfo.localEmail = config->emailInfo.sender;
 	loginInfo.useSSL = true;
-	loginInfo.caCertificatePath = config.emailInfo.caCertificatePath;
+	loginInfo.caCertificatePath = config->emailInfo.caCertificatePath;
 
-	recipients.resize(config.emailInfo.recipients.size());
-	for (unsigned int i = 0; i < recipients.size(); ++i)
+	if (config->UsesTransport("gmail"))
 	{
-		recipients[i].address = config.emailInfo.recipients[i];
-		recipients[i].displayName = config.emailInfo.recipients[i];
+		EmailSender::LoginInfo gmailLoginInfo(loginInfo);
+		gmailLoginInfo.smtpUrl = std::string("https://gmail.googleapis.com/gmail/v1/users/me/messages/send?alt=json");
+		gmailLoginInfo.oAuth2Token = UString::ToNarrowString(OAuth2Interface::Get().GetRefreshToken());
+		dispatcher.Add(std::make_unique<EmailTransport>(EmailTransport::Protocol::GmailREST, gmailLoginInfo, recipients));
 	}
+
+	if (config->UsesTransport("smtp"))
+	{
+		EmailSender::LoginInfo smtpLoginInfo(loginInfo);
+		smtpLoginInfo.smtpUrl = config->emailInfo.smtpURL;
+		smtpLoginInfo.password = config->emailInfo.smtpPassword;
+		dispatcher.Add(std::make_unique<EmailTransport>(EmailTransport::Protocol::SMTP, smtpLoginInfo, recipients));
+	}
+
+	if (config->UsesTransport("webhook"))
+	{
+		for (const auto& url : config->webhookURLs)
+			dispatcher.Add(std::make_unique<WebhookTransport>(url, config->emailInfo.caCertificatePath));
+	}
+
+	if (config->UsesTransport("file"))
+		dispatcher.Add(std::make_unique<FileTransport>(config->outputFile));
+}
+
+void BirdNotifier::RemoveDuplicates(std::vector<EBirdInterface::ObservationInfo>& observations, std::pmr::memory_resource* resource)
+{
+	std::pmr::unordered_set<std::basic_string_view<UString::Char>> ids(observations.size(), resource);
+	auto isDuplicate([&ids](const EBirdInterface::ObservationInfo& o) {
+		return !ids.insert(o.observationID).second;
+	});
+
+	observations.erase(std::remove_if(observations.begin(), observations.end(), isDuplicate), observations.end());
 }
 
 void BirdNotifier::ExcludeSpecies(std::vector<EBirdInterface::ObservationInfo>& observations, const std::vector<std::string>& exclude)
@@ -240,25 +833,124 @@ void BirdNotifier::ExcludeSpecies(std::vector<EBirdInterface::ObservationInfo>&
 	observations.erase(std::remove_if(observations.begin(), observations.end(), nameIsInList), observations.end());
 }
 
-void BirdNotifier::ExcludeObservations(std::vector<EBirdInterface::ObservationInfo>& observations, const std::vector<ReportedObservation>& exclude)
+bool BirdNotifier::NeedsTaxonomy() const
 {
-	auto observationIsInList([&exclude](const EBirdInterface::ObservationInfo& o) {
-		for (const auto& e : exclude)
+	return !config->excludeFamilies.empty() || !config->excludeOrders.empty() || config->taxonomicSort;
+}
+
+void BirdNotifier::ExcludeTaxa(std::vector<EBirdInterface::ObservationInfo>& observations, const TaxonomyCache& taxonomy,
+	const std::vector<std::string>& excludeFamilies, const std::vector<std::string>& excludeOrders)
+{
+	auto taxonIsInList([&](const EBirdInterface::ObservationInfo& o) {
+		TaxonomyCache::Taxon taxon;
+		if (!taxonomy.Find(UString::ToNarrowString(o.speciesCode), taxon))
+			return false;// Unknown to our copy of the taxonomy (maybe it's newer than the cache) - err on the side of reporting
+
+		for (const auto& f : excludeFamilies)
 		{
-			if (o.observationID == UString::ToStringType(e.observationId))
+			if (taxon.familyCode == f || taxon.familyCommonName == f || taxon.familyScientificName == f)
 				return true;
 		}
+
+		for (const auto& e : excludeOrders)
+		{
+			if (taxon.order == e)
+				return true;
+		}
+
 		return false;
 	});
 
+	observations.erase(std::remove_if(observations.begin(), observations.end(), taxonIsInList), observations.end());
+}
+
+void BirdNotifier::SortTaxonomically(std::vector<EBirdInterface::ObservationInfo>& observations, const TaxonomyCache& taxonomy)
+{
+	auto getTaxonOrder([&taxonomy](const EBirdInterface::ObservationInfo& o) {
+		TaxonomyCache::Taxon taxon;
+		if (!taxonomy.Find(UString::ToNarrowString(o.speciesCode), taxon))
+			return std::numeric_limits<double>::max();// Unknown species go at the end
+		return taxon.taxonOrder;
+	});
+
+	std::vector<std::pair<double, EBirdInterface::ObservationInfo>> keyed;
+	keyed.reserve(observations.size());
+	for (auto& o : observations)
+		keyed.emplace_back(getTaxonOrder(o), std::move(o));
+
+	std::stable_sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+
+	for (unsigned int i = 0; i < keyed.size(); ++i)
+		observations[i] = std::move(keyed[i].second);
+}
+
+// Records written before fingerprints were added get one the first time they're matched (without counting as
+// an update); the records given a fingerprint are also copied to fingerprinted
+void BirdNotifier::ExcludeObservations(std::vector<EBirdInterface::ObservationInfo>& observations, std::vector<ReportedObservation>& exclude,
+	const bool& keepUpdated, std::pmr::memory_resource* resource, std::vector<ReportedObservation>& fingerprinted)
+{
+	// Index what we fetched (rather than the list, which may be much larger) and make one pass over the list to find matches
+	std::pmr::unordered_set<std::string> candidates(observations.size(), resource);
+	for (const auto& o : observations)
+	{
+		for (const auto& key : { o.observationID, o.legacyObservationID })
+		{
+			auto id(UString::ToNarrowString(key));
+			if (!id.empty())
+				candidates.insert(std::move(id));
+		}
+	}
+
+	if (candidates.empty())
+		return;
+
+	std::pmr::unordered_map<std::string_view, ReportedObservation*> matches(candidates.size(), resource);
+	for (auto& e : exclude)
+	{
+		if (candidates.find(e.observationId) != candidates.end())
+			matches.emplace(e.observationId, &e);
+	}
+
+	auto findMatch([&matches](const EBirdInterface::ObservationInfo& o)
+	{
+		auto match(matches.find(UString::ToNarrowString(o.observationID)));
+		if (match == matches.end() && !o.legacyObservationID.empty())
+			match = matches.find(UString::ToNarrowString(o.legacyObservationID));
+		return match;
+	});
+
+	for (auto& o : observations)
+	{
+		const auto match(findMatch(o));
+		if (match == matches.end())
+			continue;
+
+		ReportedObservation& recorded(*match->second);
+		if (recorded.fingerprint == 0)
+		{
+			recorded.fingerprint = o.Fingerprint();
+			fingerprinted.push_back(recorded);
+		}
+		else
+			o.isUpdate = keepUpdated && recorded.fingerprint != o.Fingerprint();
+	}
+
+	auto observationIsInList([&matches, &findMatch](const EBirdInterface::ObservationInfo& o) {
+		return !o.isUpdate && findMatch(o) != matches.end();
+	});
+
 	observations.erase(std::remove_if(observations.begin(), observations.end(), observationIsInList), observations.end());
 }
 
-UString::String BirdNotifier::BuildTimeString(const std::tm& dateTime, const bool& includeTime)
+void BirdNotifier::WriteTimeString(UString::OStream& ss, const std::tm& dateTime, const bool& includeTime)
 {
-	UString::OStringStream ss;
 	ss << dateTime.tm_mon + 1 << '/' << dateTime.tm_mday << '/' << dateTime.tm_year + 1900;
 	if (includeTime)
-		ss << ' ' << dateTime.tm_hour << ':' << std::setw(2) << std::setfill(UString::Char('0')) << dateTime.tm_min;
-	return ss.str();
+	{
+		const auto fill(ss.fill(UString::Char('0')));
+		ss << ' ' << dateTime.tm_hour << ':' << std::setw(2) << dateTime.tm_min;
+		ss.fill(fill);
+	}
 }
@@ -9,40 +9,99 @@
 // Local headers
 #include "birdNotifierConfig.h"
 #include "eBirdInterface.h"
-#include "email/emailSender.h"
+#include "taxonomyCache.h"
+#include "pollArena.h"
+#include "notificationStore.h"
+#include "notificationDispatcher.h"
+#include "observationSnapshot.h"
 
 // Standard C++ headers
 #include <chrono>
+#include <memory_resource>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <unordered_set>
 
 class BirdNotifier
 {
 public:
-	explicit BirdNotifier(const BirdNotifierConfig& config, UString::OStream& log) : config(config), log(log) {}
+	explicit BirdNotifier(std::shared_ptr<const BirdNotifierConfig> config, UString::OStream& log) : nextConfig(std::move(config)), log(log) {}
 	bool Run();
 
+	// Takes effect at the start of the next call to Run(); safe to call from any thread
+	void UpdateConfiguration(std::shared_ptr<const BirdNotifierConfig> newConfig);
+
+	// Most recent poll's observations; safe to call from any thread, and never waits on the poll in progress
+	std::shared_ptr<const ObservationSnapshot> GetSnapshot() const { return snapshot.load(); }
+
+	// Treats each saved recent/notable response in responseDirectory (in file name order) as one poll, and writes the
+	// notification each would have produced to outputDirectory instead of sending it.  Nothing is read from or written
+	// to the notification history.
+	bool Replay(const std::string& responseDirectory, const std::string& outputDirectory);
+
+	// Responses are normally parsed in the poll arena; turning that off makes the parser's allocations
+	// individual heap blocks, so that anything not freed is visible to leak checks
+	void SetParseInArena(const bool& parseInArena) { useArenaForParsing = parseInArena; }
+
+	// Called before notifications are sent, to set up anything (e.g. OAuth2 credentials) that isn't needed when there's nothing to send
+	typedef std::function<bool(const BirdNotifierConfig&)> SendPreparation;
+	void SetSendPreparation(SendPreparation preparation) { sendPreparation = std::move(preparation); }
+
 private:
-	const BirdNotifierConfig config;
+	std::atomic<std::shared_ptr<const BirdNotifierConfig>> nextConfig;
+	std::shared_ptr<const BirdNotifierConfig> config;// Snapshot for the current cycle
 	UString::OStream& log;
 
-	struct ReportedObservation
-	{
-		std::string observationId;
-		std::string observationDate;
-	};
+	PollArena arena;// Scratch memory for one cycle; released at the end of Run()
+	bool useArenaForParsing = true;
+
+	// Replaced wholesale after each poll; readers keep whatever version they loaded alive for as long as they hold it.
+	// Not lock-free with libstdc++ (a spin lock guards the reference count update), but nothing is held for longer than that.
+	std::atomic<std::shared_ptr<const ObservationSnapshot>> snapshot;
+	unsigned int cycle = 0;
+	SendPreparation sendPreparation;
 
-	bool ReadPreviousObservations(std::vector<ReportedObservation>& observations);
-	bool ParseReportedObservationLine(const std::string& line, ReportedObservation& o);
+	bool Poll();
+
+	typedef NotificationStore::ReportedObservation ReportedObservation;
+
+	void PublishSnapshot(const std::vector<EBirdInterface::ObservationInfo>& observations);
+	bool ProcessNewObservations(NotificationStore& store, std::vector<EBirdInterface::ObservationInfo>& observations);
+	EBirdInterface CreateEBirdInterface() const;
+	// Fails only if nothing could be fetched; failedWatches lists (in order) the indices of watches with at least one failed request
+	bool GetRecentObservations(const std::vector<WatchConfig>& watches, std::vector<EBirdInterface::ObservationInfo>& observations, std::vector<size_t>& failedWatches);
+	void RemoveExpiredObservations(std::vector<ReportedObservation>& processedObservations) const;
 	void UpdateProcessedObservations(std::vector<ReportedObservation>& processedObservations, const std::vector<EBirdInterface::ObservationInfo>& observations);
-	bool WritePreviousObservations(const std::vector<ReportedObservation>& observations);
+	static ReportedObservation MakeReportedObservation(const EBirdInterface::ObservationInfo& o);
+
+	bool IsSharded() const { return !config->workerID.empty(); }
+	bool SelectWatches(NotificationStore& store, std::vector<WatchConfig>& watches);
+	bool LockStore(NotificationStore& store);
+	void RemoveRecentlyFetched(NotificationStore& store, std::vector<WatchConfig>& watches) const;
+	void RecordFetchTimes(NotificationStore& store, const std::vector<WatchConfig>& watches, const int64_t& fetchTime) const;
+	static std::string GetWatchKey(const WatchConfig& w);
 
-	bool SendNotification(const std::vector<EBirdInterface::ObservationInfo>& observations);
-	void BuildEmailEssentials(EmailSender::LoginInfo& loginInfo, std::vector<EmailSender::AddressInfo>& recipients);
-	std::string BuildMessageBody(const std::vector<EBirdInterface::ObservationInfo>& observations);
+	bool SendNotification(NotificationStore& store, const std::vector<EBirdInterface::ObservationInfo>& observations);// Also retries anything still pending
+	void AddTransports(NotificationDispatcher& dispatcher) const;
+	std::string BuildMessageBody(const std::vector<EBirdInterface::ObservationInfo>& observations, const bool& html);
 
+	static void ForEachInParallel(const size_t& count, const std::function<void(const size_t&, UString::OStream&)>& work, UString::OStream& log);
+
+	static void RemoveDuplicates(std::vector<EBirdInterface::ObservationInfo>& observations, std::pmr::memory_resource* resource);
 	static void ExcludeSpecies(std::vector<EBirdInterface::ObservationInfo>& observations, const std::vector<std::string>& exclude);
-	static void ExcludeObservations(std::vector<EBirdInterface::ObservationInfo>& observations, const std::vector<ReportedObservation>& exclude);
+	bool NeedsTaxonomy() const;
+	static void ExcludeTaxa(std::vector<EBirdInterface::ObservationInfo>& observations, const TaxonomyCache& taxonomy,
+		const std::vector<std::string>& excludeFamilies, const std::vector<std::string>& excludeOrders);
+	static void SortTaxonomically(std::vector<EBirdInterface::ObservationInfo>& observations, const TaxonomyCache& taxonomy);
+	static void ExcludeObservations(std::vector<EBirdInterface::ObservationInfo>& observations, std::vector<ReportedObservation>& exclude,
+		const bool& keepUpdated, std::pmr::memory_resource* resource, std::vector<ReportedObservation>& fingerprinted);
+
+	static bool FilterNeedsRebuild(const BloomFilter& filter);
+	static std::unordered_set<std::string> GetPossiblyProcessedIDs(const std::vector<EBirdInterface::ObservationInfo>& observations, const BloomFilter& filter);
+	BloomFilter BuildFilter(const std::vector<ReportedObservation>& observations) const;
 
-	static UString::String BuildTimeString(const std::tm& dateTime, const bool& includeTime);
+	static void WriteTimeString(UString::OStream& ss, const std::tm& dateTime, const bool& includeTime);
 	static bool DateStringToTimePoint(const std::string& s, std::chrono::system_clock::time_point& tp);
 	static bool ExtractAndParseDateToken(std::istringstream& ss, const char& seperator, int& value, const std::string& fieldName);
 };
@@ -6,6 +6,10 @@
 // Local headers
 #include "birdNotifier.h"
 #include "birdNotifierConfigFile.h"
+#include "configWatcher.h"
+#include "startupProfiler.h"
+#include "statusServer.h"
+#include "responseArchive.h"
 #include "email/oAuth2Interface.h"
 #include "logging/logger.h"
 #include "logging/combinedLogger.h"
@@ -14,12 +18,41 @@
 #include <string>
 #include <iostream>
 #include <memory>
+#include <chrono>
+#include <optional>
 
 static const UString::String oAuthTokenFileName(_T(".oAuthToken"));
 
 void PrintUsage(const std::string& calledAs)
 {
-	std::cout << "Usage:  " << calledAs << " <config file name>" << std::endl;
+	std::cout << "Usage:  " << calledAs << " [--profile-startup] <config file name>\n"
+		<< "        " << calledAs << " --replay <saved response directory> <output directory> <config file name>\n"
+		<< "        " << calledAs << " --build-dictionary <saved response directory>" << std::endl;
+}
+
+// Prints the dictionary as a string literal, ready to add to ResponseArchive::dictionaries
+int BuildArchiveDictionary(const std::string& responseDirectory, UString::OStream& log)
+{
+	constexpr size_t maxSize(8 * 1024);
+	std::string dictionary;
+	if (!ResponseArchive::BuildDictionary(responseDirectory, maxSize, dictionary, log))
+		return 1;
+
+	constexpr size_t lineLength(100);
+	std::cout << "\tstd::string(\n";
+	for (size_t i = 0; i < dictionary.size(); i += lineLength)
+	{
+		std::cout << "\t\t\"";
+		for (const char& c : dictionary.substr(i, lineLength))
+		{
+			if (c == '"' || c == '\\')
+				std::cout << '\\';
+			std::cout << c;
+		}
+		std::cout << "\"\n";
+	}
+	std::cout << "\t)" << std::endl;
+	return 0;
 }
 
 bool SetupOAuth2Interface(const EmailConfig& email, UString::OStream& log)
@@ -89,6 +122,60 @@ bool SetupOAuth2Interface(const EmailConfig& email, UString::OStream& log)
 	return true;
 }
 
+bool OAuth2SettingsChanged(const EmailConfig& a, const EmailConfig& b)
+{
+	return a.sender != b.sender ||
+		a.oAuth2ClientID != b.oAuth2ClientID ||
+		a.oAuth2ClientSecret != b.oAuth2ClientSecret ||
+		a.caCertificatePath != b.caCertificatePath;
+}
+
+// OAuth2 setup involves reading (and possibly writing) the token file and a round trip to the
+// server, so it's deferred until there is something to send, and redone only if the settings change
+BirdNotifier::SendPreparation MakeLazyOAuth2Setup(UString::OStream& log)
+{
+	return [&log, current = std::optional<EmailConfig>()](const BirdNotifierConfig& config) mutable
+	{
+		if (!config.UsesTransport("gmail"))
+			return true;
+
+		if (current && !OAuth2SettingsChanged(*current, config.emailInfo))
+			return true;
+
+		current.reset();
+		if (!SetupOAuth2Interface(config.emailInfo, log))
+			return false;
+
+		current = config.emailInfo;
+		return true;
+	};
+}
+
+// Returns nullptr (leaving the current configuration in effect) if the new file is invalid
+// or can't be applied without restarting
+std::shared_ptr<const BirdNotifierConfig> ReloadConfiguration(const std::string& fileName, const BirdNotifierConfig& current, UString::OStream& log)
+{
+	log << "Configuration file changed; reloading..." << std::endl;
+	BirdNotifierConfigFile configFile(log);
+	if (!configFile.ReadConfiguration(UString::ToStringType(fileName)))
+	{
+		log << "Invalid configuration; continuing with previous settings" << std::endl;
+		return nullptr;
+	}
+
+	auto config(std::make_shared<BirdNotifierConfig>(configFile.GetConfig()));
+	if (config->pollInterval == 0)
+	{
+		log << "POLL_INTERVAL cannot be changed to zero while running; continuing with previous settings (restart to check once and exit)" << std::endl;
+		return nullptr;
+	}
+
+	if (config->statusSocket != current.statusSocket)
+		log << "STATUS_SOCKET is only read at startup; restart for the change to take effect" << std::endl;
+
+	return config;
+}
+
 static const UString::String logFileName(_T("birdNotifier.log"));
 
 int main(int argc, char* argv[])
@@ -98,22 +185,75 @@ int main(int argc, char* argv[])
 	logger.Add(std::make_unique<Logger>(logFile));
 	logger.Add(std::make_unique<Logger>(Cout));
 	
-	if (argc != 2)
+	const std::string profileArgument("--profile-startup");
+	const std::string replayArgument("--replay");
+	const std::string dictionaryArgument("--build-dictionary");
+	std::string replayResponseDirectory, replayOutputDirectory;
+	if (argc == 3 && argv[1] == dictionaryArgument)
+		return BuildArchiveDictionary(argv[2], logger);
+	else if (argc == 3 && argv[1] == profileArgument)
+		StartupProfiler::Enable();
+	else if (argc == 5 && argv[1] == replayArgument)
+	{
+		replayResponseDirectory = argv[2];
+		replayOutputDirectory = argv[3];
+	}
+	else if (argc != 2)
 	{
 		PrintUsage(argv[0]);
 		return 1;
 	}
 
+	const std::string configFileName(argv[argc - 1]);
 	BirdNotifierConfigFile configFile(logger);
-	if (!configFile.ReadConfiguration(UString::ToStringType(argv[1])))
+	if (!configFile.ReadConfiguration(UString::ToStringType(configFileName)))
 		return 1;
+	StartupProfiler::Mark("configuration read");
 
-	if (!SetupOAuth2Interface(configFile.GetConfig().emailInfo, logger))
-		return 1;
+	auto config(std::make_shared<const BirdNotifierConfig>(configFile.GetConfig()));
+	BirdNotifier birdNotifier(config, logger);
+	if (!replayResponseDirectory.empty())
+		return birdNotifier.Replay(replayResponseDirectory, replayOutputDirectory) ? 0 : 1;
 
-	BirdNotifier birdNotifier(configFile.GetConfig(), logger);
-	if (!birdNotifier.Run())
-		return 1;
+	birdNotifier.SetSendPreparation(MakeLazyOAuth2Setup(logger));
+	if (config->pollInterval == 0)
+	{
+		const bool success(birdNotifier.Run());
+		StartupProfiler::Mark("finished");
+		StartupProfiler::Report(logger);
+		return success ? 0 : 1;
+	}
+
+	StatusServer statusServer([&birdNotifier]() { return birdNotifier.GetSnapshot(); }, logger);
+	if (!config->statusSocket.empty() && !statusServer.Start(config->statusSocket))
+		logger << "Continuing without status socket" << std::endl;
+
+	ConfigWatcher watcher(configFileName, logger);
+	while (true)
+	{
+		if (!birdNotifier.Run())
+			logger << "Failed to check for new observations; will try again next cycle" << std::endl;
+		StartupProfiler::Mark("first cycle finished");
+		if (StartupProfiler::IsEnabled())
+		{
+			StartupProfiler::Report(logger);
+			StartupProfiler::Disable();
+		}
+
+		const auto nextPoll(std::chrono::steady_clock::now() + std::chrono::minutes(config->pollInterval));
+		for (auto now = std::chrono::steady_clock::now(); now < nextPoll; now = std::chrono::steady_clock::now())
+		{
+			if (!watcher.WaitForChange(std::chrono::duration_cast<std::chrono::milliseconds>(nextPoll - now)))
+				continue;
+
+			auto newConfig(ReloadConfiguration(configFileName, *config, logger));
+			if (newConfig)
+			{
+				config = newConfig;
+				birdNotifier.UpdateConfiguration(config);
+			}
+		}
+	}
 
 	return 0;
 }
@@ -9,28 +9,78 @@
 // Local headers
 #include <string>
 #include <vector>
+#include <algorithm>
 
 struct EmailConfig
 {
 	std::string sender;
 	std::vector<std::string> recipients;
 
-	std::string oAuth2ClientID;
+	std::string oAuth2ClientID;// For Gmail
 	std::string oAuth2ClientSecret;
 	std::string caCertificatePath;
+
+	std::string smtpURL;// For SMTP, e.g. smtps://smtp.example.com:465
+	std::string smtpPassword;
+};
+
+struct WatchConfig
+{
+	std::string regionCode;// Empty when watching the area around a point
+
+	double latitude = 0.0;
+	double longitude = 0.0;
+	double radius = 0.0;// [km]
+
+	std::vector<std::string> speciesCodes;// Empty to watch all notable species
 };
 
 struct BirdNotifierConfig
 {
 	std::string alreadyNotifiedFile;
+	bool compressHistory;
+	std::string responseArchive;// Directory in which to save raw responses (e.g. for replaying); empty to disable
+	unsigned int pollInterval;// [min]; zero to check once and exit (i.e. when launched by cron)
+	std::string statusSocket;// Unix socket on which to answer status queries (long-running mode only; read at startup)
+	unsigned int fetchCacheTime;// [min]; watches fetched more recently than this are skipped (zero to always fetch)
+
+	// When set, watches are divided among all live workers sharing alreadyNotifiedFile
+	std::string workerID;
+	unsigned int workerLease;// [sec]
 
 	std::string eBirdAPIKey;
-	std::string regionCode;
+	std::string eBirdAPIRoot;// Empty for eBird itself; otherwise e.g. a local mock server for testing
+	std::vector<std::string> regionCodes;
+	std::vector<std::string> watchSpecifications;
+	std::vector<WatchConfig> watches;// Built from regionCodes and watchSpecifications
 
 	std::vector<std::string> excludeSpecies;
+	std::vector<std::string> excludeFamilies;// Family code, common name or scientific name
+	std::vector<std::string> excludeOrders;
+	bool taxonomicSort;
+	bool notifyUpdates;// Notify again when a reported observation changes (reviewed, validity or count revised)
 	unsigned int daysBack;
 
+	// Group repeat reports of the same bird into a single event
+	bool clusterEvents;
+	double clusterDistance;// [km]
+	unsigned int clusterWindow;// [days]
+
+	std::string taxonomyFile;
+	unsigned int taxonomyMaxAge;// [days]
+
+	// Any of "gmail", "smtp", "webhook" and "file"; Gmail if none are specified
+	std::vector<std::string> transports;
+	unsigned int deliveryAttempts;// Per transport
+
 	EmailConfig emailInfo;
+	std::vector<std::string> webhookURLs;
+	std::string outputFile;// "-" for stdout
+
+	bool UsesTransport(const std::string& name) const
+	{
+		return std::find(transports.begin(), transports.end(), name) != transports.end();
+	}
 };
 
 #endif// BIRD_NOTIFIER_CONFIG_H_
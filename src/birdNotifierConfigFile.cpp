@@ -6,15 +6,40 @@
 // Local headers
 #include "birdNotifierConfigFile.h"
 
+// Standard C++ headers
+#include <sstream>
+
 void BirdNotifierConfigFile::BuildConfigItems()
 {
 	AddConfigItem(_T("PREVIOUS_NOTIFICATION_FILE"), config.alreadyNotifiedFile);
+	AddConfigItem(_T("COMPRESS_HISTORY"), config.compressHistory);
+	AddConfigItem(_T("RESPONSE_ARCHIVE"), config.responseArchive);
+	AddConfigItem(_T("POLL_INTERVAL"), config.pollInterval);
+	AddConfigItem(_T("FETCH_CACHE_TIME"), config.fetchCacheTime);
+	AddConfigItem(_T("STATUS_SOCKET"), config.statusSocket);
+	AddConfigItem(_T("WORKER_ID"), config.workerID);
+	AddConfigItem(_T("WORKER_LEASE"), config.workerLease);
 
 	AddConfigItem(_T("EBIRD_API_KEY"), config.eBirdAPIKey);
-	AddConfigItem(_T("REGION_CODE"), config.regionCode);
+	AddConfigItem(_T("EBIRD_API_ROOT"), config.eBirdAPIRoot);
+	AddConfigItem(_T("REGION_CODE"), config.regionCodes);
+	AddConfigItem(_T("WATCH"), config.watchSpecifications);
 
 	AddConfigItem(_T("EXCLUDE"), config.excludeSpecies);
+	AddConfigItem(_T("EXCLUDE_FAMILY"), config.excludeFamilies);
+	AddConfigItem(_T("EXCLUDE_ORDER"), config.excludeOrders);
+	AddConfigItem(_T("TAXONOMIC_SORT"), config.taxonomicSort);
+	AddConfigItem(_T("NOTIFY_UPDATES"), config.notifyUpdates);
 	AddConfigItem(_T("DAYS_BACK"), config.daysBack);
+	AddConfigItem(_T("CLUSTER_EVENTS"), config.clusterEvents);
+	AddConfigItem(_T("CLUSTER_DISTANCE"), config.clusterDistance);
+	AddConfigItem(_T("CLUSTER_WINDOW"), config.clusterWindow);
+
+	AddConfigItem(_T("TAXONOMY_FILE"), config.taxonomyFile);
+	AddConfigItem(_T("TAXONOMY_MAX_AGE"), config.taxonomyMaxAge);
+
+	AddConfigItem(_T("TRANSPORT"), config.transports);
+	AddConfigItem(_T("DELIVERY_ATTEMPTS"), config.deliveryAttempts);
 
 	AddConfigItem(_T("SENDER"), config.emailInfo.sender);
 	AddConfigItem(_T("RECIPIENT"), config.emailInfo.recipients);
@@ -22,12 +47,29 @@ void BirdNotifierConfigFile::BuildConfigItems()
 	AddConfigItem(_T("OAUTH_CLIENT_ID"), config.emailInfo.oAuth2ClientID);
 	AddConfigItem(_T("OAUTH_CLIENT_SECRET"), config.emailInfo.oAuth2ClientSecret);
 	AddConfigItem(_T("CA_CERT_PATH"), config.emailInfo.caCertificatePath);
+	AddConfigItem(_T("SMTP_URL"), config.emailInfo.smtpURL);
+	AddConfigItem(_T("SMTP_PASSWORD"), config.emailInfo.smtpPassword);
+
+	AddConfigItem(_T("WEBHOOK_URL"), config.webhookURLs);
+	AddConfigItem(_T("OUTPUT_FILE"), config.outputFile);
 }
 
 void BirdNotifierConfigFile::AssignDefaults()
 {
 	config.alreadyNotifiedFile = ".previouslyNotified";
+	config.compressHistory = false;
+	config.pollInterval = 0;
+	config.fetchCacheTime = 0;
+	config.workerLease = 600;
 	config.daysBack = 2;
+	config.taxonomicSort = false;
+	config.notifyUpdates = false;
+	config.clusterEvents = false;
+	config.clusterDistance = 5.0;
+	config.clusterWindow = 3;
+	config.taxonomyFile = ".taxonomy";
+	config.taxonomyMaxAge = 30;
+	config.deliveryAttempts = 3;
 }
 
 bool BirdNotifierConfigFile::ConfigIsOK()
@@ -40,41 +82,188 @@ bool BirdNotifierConfigFile::ConfigIsOK()
 		configurationOK = false;
 	}
 
-	if (config.regionCode.empty())
+	config.watches.clear();
+	for (const auto& r : config.regionCodes)
+	{
+		WatchConfig w;
+		w.regionCode = r;
+		config.watches.push_back(w);
+	}
+
+	for (const auto& spec : config.watchSpecifications)
 	{
-		Cerr << GetKey(config.regionCode) << " must be specified" << '\n';
+		WatchConfig w;
+		if (!ParseWatch(spec, w))
+		{
+			Cerr << "Invalid " << GetKey(config.watchSpecifications) << " '" << UString::ToStringType(spec) << "'; expected <region>[:<species>,...] or <lat>,<lng>,<radius>[:<species>,...]\n";
+			configurationOK = false;
+		}
+		else
+			config.watches.push_back(w);
+	}
+
+	if (config.watches.empty())
+	{
+		Cerr << GetKey(config.regionCodes) << " or " << GetKey(config.watchSpecifications) << " must be specified" << '\n';
 		configurationOK = false;
 	}
 
+	if (!config.workerID.empty())
+	{
+		if (config.workerID.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_") != std::string::npos)
+		{
+			Cerr << GetKey(config.workerID) << " may contain only letters, digits, '-' and '_'" << '\n';
+			configurationOK = false;
+		}
+
+		if (config.alreadyNotifiedFile.empty())
+		{
+			Cerr << GetKey(config.alreadyNotifiedFile) << " must be specified when " << GetKey(config.workerID) << " is set" << '\n';
+			configurationOK = false;
+		}
+
+		// Heartbeats are only refreshed once per poll
+		if (config.workerLease <= config.pollInterval * 60)
+		{
+			Cerr << GetKey(config.workerLease) << " must be longer than " << GetKey(config.pollInterval) << '\n';
+			configurationOK = false;
+		}
+	}
+
 	if (config.daysBack == 0)
 	{
 		Cerr << GetKey(config.daysBack) << " must be strictly positive" << '\n';
 		configurationOK = false;
 	}
 
-	if (config.emailInfo.sender.empty())
+	if (config.clusterEvents && (config.clusterDistance <= 0.0 || config.clusterWindow == 0))
 	{
-		Cerr << GetKey(config.emailInfo.sender) << " must be specified" << '\n';
+		Cerr << GetKey(config.clusterDistance) << " and " << GetKey(config.clusterWindow) << " must be strictly positive" << '\n';
 		configurationOK = false;
 	}
 
-	if (config.emailInfo.recipients.empty())
+	if ((!config.excludeFamilies.empty() || !config.excludeOrders.empty() || config.taxonomicSort) && config.taxonomyFile.empty())
 	{
-		Cerr << GetKey(config.emailInfo.recipients) << " must be specified" << '\n';
+		Cerr << GetKey(config.taxonomyFile) << " must be specified when using taxonomic exclusions or sorting" << '\n';
 		configurationOK = false;
 	}
 
-	if (config.emailInfo.oAuth2ClientID.empty())
+	if (config.transports.empty())
+		config.transports.push_back("gmail");
+
+	for (const auto& t : config.transports)
 	{
-		Cerr << GetKey(config.emailInfo.oAuth2ClientID) << " must be specified" << '\n';
+		if (t != "gmail" && t != "smtp" && t != "webhook" && t != "file")
+		{
+			Cerr << "Unknown " << GetKey(config.transports) << " '" << UString::ToStringType(t) << "'\n";
+			configurationOK = false;
+		}
+	}
+
+	if (config.deliveryAttempts == 0)
+	{
+		Cerr << GetKey(config.deliveryAttempts) << " must be strictly positive" << '\n';
 		configurationOK = false;
 	}
 
-	if (config.emailInfo.oAuth2ClientSecret.empty())
+	if (config.UsesTransport("gmail") || config.UsesTransport("smtp"))
 	{
-		Cerr << GetKey(config.emailInfo.oAuth2ClientSecret) << " must be specified" << '\n';
+		if (config.emailInfo.sender.empty())
+		{
+			Cerr << GetKey(config.emailInfo.sender) << " must be specified" << '\n';
+			configurationOK = false;
+		}
+
+		if (config.emailInfo.recipients.empty())
+		{
+			Cerr << GetKey(config.emailInfo.recipients) << " must be specified" << '\n';
+			configurationOK = false;
+		}
+	}
+
+	if (config.UsesTransport("gmail"))
+	{
+		if (config.emailInfo.oAuth2ClientID.empty())
+		{
+			Cerr << GetKey(config.emailInfo.oAuth2ClientID) << " must be specified" << '\n';
+			configurationOK = false;
+		}
+
+		if (config.emailInfo.oAuth2ClientSecret.empty())
+		{
+			Cerr << GetKey(config.emailInfo.oAuth2ClientSecret) << " must be specified" << '\n';
+			configurationOK = false;
+		}
+	}
+
+	if (config.UsesTransport("smtp") && config.emailInfo.smtpURL.empty())
+	{
+		Cerr << GetKey(config.emailInfo.smtpURL) << " must be specified" << '\n';
 		configurationOK = false;
 	}
 
+	if (config.UsesTransport("webhook") && config.webhookURLs.empty())
+	{
+		Cerr << GetKey(config.webhookURLs) << " must be specified" << '\n';
+		configurationOK = false;
+	}
+
+	if (config.UsesTransport("file") && config.outputFile.empty())
+	{
+		Cerr << GetKey(config.outputFile) << " must be specified" << '\n';
+		configurationOK = false;
+	}
+
+	if (!config.eBirdAPIRoot.empty() && config.eBirdAPIRoot.back() != '/')
+		config.eBirdAPIRoot.push_back('/');
+
 	return configurationOK;
 }
+
+bool BirdNotifierConfigFile::ParseWatch(const std::string& spec, WatchConfig& watch)
+{
+	const auto colon(spec.find(':'));
+	const std::string where(Trim(spec.substr(0, colon)));
+	if (where.empty())
+		return false;
+
+	if (colon != std::string::npos)
+	{
+		std::istringstream ss(spec.substr(colon + 1));
+		std::string species;
+		while (std::getline(ss, species, ','))
+		{
+			species = Trim(species);
+			if (species.empty())
+				return false;
+			watch.speciesCodes.push_back(species);
+		}
+
+		if (watch.speciesCodes.empty())
+			return false;
+	}
+
+	if (where.find(',') == std::string::npos)
+	{
+		watch.regionCode = where;
+		return true;
+	}
+
+	std::istringstream ss(where);
+	char comma1, comma2;
+	if ((ss >> watch.latitude >> comma1 >> watch.longitude >> comma2 >> watch.radius).fail() || comma1 != ',' || comma2 != ',')
+		return false;
+
+	constexpr double maxRadius(50.0);// [km] eBird limit
+	return watch.latitude >= -90.0 && watch.latitude <= 90.0 &&
+		watch.longitude >= -180.0 && watch.longitude <= 180.0 &&
+		watch.radius > 0.0 && watch.radius <= maxRadius;
+}
+
+std::string BirdNotifierConfigFile::Trim(const std::string& s)
+{
+	const auto first(s.find_first_not_of(" \t"));
+	if (first == std::string::npos)
+		return std::string();
+	return s.substr(first, s.find_last_not_of(" \t") - first + 1);
+}
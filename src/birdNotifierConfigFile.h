@@ -25,6 +25,9 @@ private:
 	void BuildConfigItems() override;
 	void AssignDefaults() override;
 	bool ConfigIsOK() override;
+
+	static bool ParseWatch(const std::string& spec, WatchConfig& watch);
+	static std::string Trim(const std::string& s);
 };
 
 #endif// BIRD_NOTIFIER_CONFIG_FILE_H_
@@ -0,0 +1,140 @@
+// File:  bloomFilter.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Compact probabilistic set of observation IDs used to avoid loading the full
+//        notification history when nothing new could possibly be in it.
+
+// Local headers
+#include "bloomFilter.h"
+#include "fnv1a.h"
+
+// Standard C++ headers
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+const char BloomFilter::fileMagic[4] = { 'B', 'N', 'B', 'F' };
+
+namespace
+{
+
+struct FileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t bitCount;
+	uint32_t hashCount;
+	uint32_t itemCount;
+	uint32_t capacity;
+	uint32_t reserved;
+	int64_t compactAfter;
+	uint64_t sourceSize;
+};
+
+}
+
+BloomFilter::BloomFilter(const uint32_t& capacity) : capacity(capacity)
+{
+	constexpr double falsePositiveRate(0.01);
+	const double ln2(std::log(2.0));
+	const double optimalBits(-static_cast<double>(capacity) * std::log(falsePositiveRate) / (ln2 * ln2));
+	bits.resize(static_cast<size_t>(std::ceil(optimalBits / 64.0)) + 1);
+	bitCount = bits.size() * 64;
+	hashCount = static_cast<uint32_t>(std::lround(static_cast<double>(bitCount) / capacity * ln2));
+	if (hashCount == 0)
+		hashCount = 1;
+}
+
+void BloomFilter::Add(const std::string_view& id)
+{
+	uint64_t h1, h2;
+	Hash(id, h1, h2);
+	for (uint32_t i = 0; i < hashCount; ++i)
+	{
+		const uint64_t bit((h1 + i * h2) % bitCount);
+		bits[bit / 64] |= uint64_t(1) << (bit % 64);
+	}
+	++itemCount;
+}
+
+bool BloomFilter::MightContain(const std::string_view& id) const
+{
+	if (bits.empty())
+		return true;// Nothing to go on
+
+	uint64_t h1, h2;
+	Hash(id, h1, h2);
+	for (uint32_t i = 0; i < hashCount; ++i)
+	{
+		const uint64_t bit((h1 + i * h2) % bitCount);
+		if ((bits[bit / 64] & (uint64_t(1) << (bit % 64))) == 0)
+			return false;
+	}
+	return true;
+}
+
+bool BloomFilter::Read(const std::string& fileName, uint64_t& sourceSize)
+{
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	FileHeader h;
+	if (!file.read(reinterpret_cast<char*>(&h), sizeof(h)) ||
+		std::memcmp(h.magic, fileMagic, sizeof(h.magic)) != 0 ||
+		h.version != fileVersion ||
+		h.bitCount == 0 || h.bitCount % 64 != 0 || h.hashCount == 0)
+		return false;
+
+	std::vector<uint64_t> words(h.bitCount / 64);
+	if (!file.read(reinterpret_cast<char*>(words.data()), words.size() * sizeof(uint64_t)))
+		return false;
+
+	bitCount = h.bitCount;
+	hashCount = h.hashCount;
+	itemCount = h.itemCount;
+	capacity = h.capacity;
+	compactAfter = h.compactAfter;
+	bits = std::move(words);
+	sourceSize = h.sourceSize;
+	return true;
+}
+
+bool BloomFilter::Write(const std::string& fileName, const uint64_t& sourceSize) const
+{
+	FileHeader h{};
+	std::memcpy(h.magic, fileMagic, sizeof(h.magic));
+	h.version = fileVersion;
+	h.bitCount = bitCount;
+	h.hashCount = hashCount;
+	h.itemCount = itemCount;
+	h.capacity = capacity;
+	h.compactAfter = compactAfter;
+	h.sourceSize = sourceSize;
+
+	const std::string tempFileName(fileName + ".tmp");
+	{
+		std::ofstream file(tempFileName, std::ios::binary);
+		if (!file.is_open() ||
+			!file.write(reinterpret_cast<const char*>(&h), sizeof(h)) ||
+			!file.write(reinterpret_cast<const char*>(bits.data()), bits.size() * sizeof(uint64_t)))
+			return false;
+	}
+
+	std::remove(fileName.c_str());
+	return std::rename(tempFileName.c_str(), fileName.c_str()) == 0;
+}
+
+// Two independent 64-bit hashes for double hashing (FNV-1a with different finalizers)
+void BloomFilter::Hash(const std::string_view& id, uint64_t& h1, uint64_t& h2)
+{
+	const uint64_t hash(FNV1a::Hash(id));
+	h1 = FNV1a::Mix(hash);
+
+	h2 = hash;
+	h2 ^= h2 >> 29;
+	h2 *= 0xc4ceb9fe1a85ec53ull;
+	h2 ^= h2 >> 32;
+	h2 |= 1;// Odd, so successive probes don't repeat early
+}
@@ -0,0 +1,54 @@
+// File:  bloomFilter.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Compact probabilistic set of observation IDs used to avoid loading the full
+//        notification history when nothing new could possibly be in it.
+
+#ifndef BLOOM_FILTER_H_
+#define BLOOM_FILTER_H_
+
+// Standard C++ headers
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+class BloomFilter
+{
+public:
+	BloomFilter() = default;
+
+	// Sized for about a 1% false positive rate at the given number of items
+	explicit BloomFilter(const uint32_t& capacity);
+
+	void Add(const std::string_view& id);
+	bool MightContain(const std::string_view& id) const;// False means definitely not present
+
+	uint32_t GetItemCount() const { return itemCount; }
+	bool IsFull() const { return itemCount > capacity; }
+
+	// Time at which the filter (and the underlying history) should be rebuilt to drop expired items,
+	// since filters can't forget items
+	int64_t GetCompactAfter() const { return compactAfter; }
+	void SetCompactAfter(const int64_t& t) { compactAfter = t; }
+
+	// sourceSize identifies the state of the underlying history when the filter was written,
+	// so the owner can tell if the two have diverged (e.g. a crash between updating one and the other)
+	bool Read(const std::string& fileName, uint64_t& sourceSize);
+	bool Write(const std::string& fileName, const uint64_t& sourceSize) const;
+
+private:
+	static const char fileMagic[4];
+	static constexpr uint32_t fileVersion = 1;
+
+	uint64_t bitCount = 0;
+	uint32_t hashCount = 0;
+	uint32_t itemCount = 0;
+	uint32_t capacity = 0;
+	int64_t compactAfter = INT64_MAX;
+	std::vector<uint64_t> bits;
+
+	static void Hash(const std::string_view& id, uint64_t& h1, uint64_t& h2);
+};
+
+#endif// BLOOM_FILTER_H_
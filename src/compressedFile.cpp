@@ -0,0 +1,126 @@
+// File:  compressedFile.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Reading and writing of files that may be gzip-compressed.  Reads are transparent,
+//        so files written before compression was enabled (or with it disabled) still work.
+
+// Local headers
+#include "compressedFile.h"
+
+// zlib headers
+#include <zlib.h>
+
+// Standard C++ headers
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+bool CompressedFile::Read(const std::string& fileName, std::string& contents)
+{
+	// gzread() passes uncompressed files through as-is
+	gzFile file(gzopen(fileName.c_str(), "rb"));
+	if (!file)
+		return false;
+
+	gzbuffer(file, 128 * 1024);
+	contents.clear();
+	constexpr unsigned int chunkSize(64 * 1024);
+	int bytesRead;
+	do
+	{
+		const size_t offset(contents.size());
+		contents.resize(offset + chunkSize);
+		bytesRead = gzread(file, contents.data() + offset, chunkSize);
+		contents.resize(offset + std::max(bytesRead, 0));
+	} while (bytesRead > 0);
+
+	return gzclose(file) == Z_OK && bytesRead == 0;
+}
+
+bool CompressedFile::ReadLines(const std::string& fileName, const std::function<bool(const std::string&)>& processLine)
+{
+	gzFile file(gzopen(fileName.c_str(), "rb"));
+	if (!file)
+		return false;
+
+	gzbuffer(file, 128 * 1024);
+	std::vector<char> chunk(64 * 1024);
+	std::string line;
+	bool ok(true);
+	int bytesRead;
+	while (ok && (bytesRead = gzread(file, chunk.data(), static_cast<unsigned int>(chunk.size()))) > 0)
+	{
+		const char* start(chunk.data());
+		const char* const end(start + bytesRead);
+		for (const char* newline; ok && (newline = static_cast<const char*>(std::memchr(start, '\n', end - start))); start = newline + 1)
+		{
+			line.append(start, newline);
+			ok = processLine(line);
+			line.clear();
+		}
+
+		if (ok)
+			line.append(start, end);
+	}
+
+	if (ok && bytesRead == 0 && !line.empty())// No newline at the end
+		ok = processLine(line);
+
+	return gzclose(file) == Z_OK && ok && bytesRead == 0;
+}
+
+// A crash part way through leaves the old file intact
+bool CompressedFile::Write(const std::string& fileName, const std::string& contents, const bool& compress)
+{
+	const std::string tempFileName(fileName + ".tmp");
+	bool ok;
+	if (compress)
+		ok = WriteGZip(tempFileName, "wb", contents);
+	else
+	{
+		std::ofstream file(tempFileName, std::ios::binary);
+		ok = file.is_open() && file.write(contents.data(), contents.size());
+		file.close();
+		ok = ok && !file.fail();
+	}
+
+	std::error_code ec;
+	if (ok)
+		std::filesystem::rename(tempFileName, fileName, ec);
+
+	if (!ok || ec)
+	{
+		std::filesystem::remove(tempFileName, ec);
+		return false;
+	}
+
+	return true;
+}
+
+bool CompressedFile::Append(const std::string& fileName, const std::string& contents, const bool& compress)
+{
+	if (compress)
+		return WriteGZip(fileName, "ab", contents);
+
+	std::ofstream file(fileName, std::ios::binary | std::ios::app);
+	return file.is_open() && file.write(contents.data(), contents.size());
+}
+
+bool CompressedFile::IsCompressed(const std::string& fileName)
+{
+	std::ifstream file(fileName, std::ios::binary);
+	unsigned char magic[2];
+	return file.read(reinterpret_cast<char*>(magic), sizeof(magic)) && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+bool CompressedFile::WriteGZip(const std::string& fileName, const char* mode, const std::string& contents)
+{
+	gzFile file(gzopen(fileName.c_str(), mode));
+	if (!file)
+		return false;
+
+	const bool ok(contents.empty() || gzwrite(file, contents.data(), static_cast<unsigned int>(contents.size())) == static_cast<int>(contents.size()));
+	return gzclose(file) == Z_OK && ok;
+}
@@ -0,0 +1,36 @@
+// File:  compressedFile.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Reading and writing of files that may be gzip-compressed.  Reads are transparent,
+//        so files written before compression was enabled (or with it disabled) still work.
+
+#ifndef COMPRESSED_FILE_H_
+#define COMPRESSED_FILE_H_
+
+// Standard C++ headers
+#include <string>
+#include <functional>
+
+class CompressedFile
+{
+public:
+	// Handles plain files and any number of concatenated gzip members
+	static bool Read(const std::string& fileName, std::string& contents);
+
+	// Like Read(), but passes the contents to processLine one line at a time (without the
+	// newline) rather than holding the whole file in memory.  Stops if processLine returns false.
+	static bool ReadLines(const std::string& fileName, const std::function<bool(const std::string&)>& processLine);
+
+	// Replaces the file atomically (via <fileName>.tmp)
+	static bool Write(const std::string& fileName, const std::string& contents, const bool& compress);
+
+	// Compressed data is appended as a new gzip member, so appending doesn't require rewriting the file
+	static bool Append(const std::string& fileName, const std::string& contents, const bool& compress);
+
+	static bool IsCompressed(const std::string& fileName);
+
+private:
+	static bool WriteGZip(const std::string& fileName, const char* mode, const std::string& contents);
+};
+
+#endif// COMPRESSED_FILE_H_
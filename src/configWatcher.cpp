@@ -0,0 +1,109 @@
+// File:  configWatcher.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Watches the configuration file for modifications.
+
+// Local headers
+#include "configWatcher.h"
+
+// Standard C++ headers
+#include <thread>
+#include <algorithm>
+
+#ifndef _WIN32
+// *nix headers
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif// _WIN32
+
+#ifdef _WIN32
+
+ConfigWatcher::ConfigWatcher(const std::string& fileName, UString::OStream& log) : path(fileName), log(log)
+{
+	std::error_code ec;
+	lastWriteTime = std::filesystem::last_write_time(path, ec);
+}
+
+ConfigWatcher::~ConfigWatcher() = default;
+
+bool ConfigWatcher::WaitForChange(const std::chrono::milliseconds& timeout)
+{
+	// No inotify here - fall back to polling the modification time
+	const auto end(std::chrono::steady_clock::now() + timeout);
+	do
+	{
+		std::error_code ec;
+		const auto writeTime(std::filesystem::last_write_time(path, ec));
+		if (!ec && writeTime != lastWriteTime)
+		{
+			lastWriteTime = writeTime;
+			return true;
+		}
+
+		std::this_thread::sleep_for(std::min(std::chrono::milliseconds(1000),
+			std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now())));
+	} while (std::chrono::steady_clock::now() < end);
+
+	return false;
+}
+
+#else
+
+ConfigWatcher::ConfigWatcher(const std::string& fileName, UString::OStream& log) : path(std::filesystem::absolute(fileName)), log(log)
+{
+	inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFD < 0)
+	{
+		log << "Failed to initialize inotify:  " << std::strerror(errno) << std::endl;
+		watchDescriptor = -1;
+		return;
+	}
+
+	// Watch the directory rather than the file itself, since most editors save by replacing the file
+	watchDescriptor = inotify_add_watch(inotifyFD, path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (watchDescriptor < 0)
+		log << "Failed to watch '" << UString::ToStringType(path.parent_path().string()) << "':  " << std::strerror(errno) << std::endl;
+}
+
+ConfigWatcher::~ConfigWatcher()
+{
+	if (inotifyFD >= 0)
+		close(inotifyFD);
+}
+
+bool ConfigWatcher::WaitForChange(const std::chrono::milliseconds& timeout)
+{
+	if (watchDescriptor < 0)
+	{
+		std::this_thread::sleep_for(timeout);
+		return false;
+	}
+
+	pollfd pfd{};
+	pfd.fd = inotifyFD;
+	pfd.events = POLLIN;
+	if (poll(&pfd, 1, static_cast<int>(std::max(timeout.count(), static_cast<decltype(timeout.count())>(0)))) <= 0)
+		return false;
+
+	const auto fileName(path.filename().string());
+	bool changed(false);
+	alignas(inotify_event) char buffer[4096];
+	ssize_t length;
+	while ((length = read(inotifyFD, buffer, sizeof(buffer))) > 0)
+	{
+		for (char* p = buffer; p < buffer + length; )
+		{
+			const inotify_event* event(reinterpret_cast<const inotify_event*>(p));
+			if (event->len > 0 && fileName == event->name)
+				changed = true;
+			p += sizeof(inotify_event) + event->len;
+		}
+	}
+
+	return changed;
+}
+
+#endif// _WIN32
@@ -0,0 +1,41 @@
+// File:  configWatcher.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Watches the configuration file for modifications.
+
+#ifndef CONFIG_WATCHER_H_
+#define CONFIG_WATCHER_H_
+
+// Local headers
+#include "utilities/uString.h"
+
+// Standard C++ headers
+#include <string>
+#include <chrono>
+#include <filesystem>
+
+class ConfigWatcher
+{
+public:
+	ConfigWatcher(const std::string& fileName, UString::OStream& log);
+	~ConfigWatcher();
+
+	ConfigWatcher(const ConfigWatcher&) = delete;
+	ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+	// Blocks for up to timeout; returns true as soon as the file has been written or replaced
+	bool WaitForChange(const std::chrono::milliseconds& timeout);
+
+private:
+	const std::filesystem::path path;
+	UString::OStream& log;
+
+#ifdef _WIN32
+	std::filesystem::file_time_type lastWriteTime;
+#else
+	int inotifyFD;
+	int watchDescriptor;
+#endif// _WIN32
+};
+
+#endif// CONFIG_WATCHER_H_
@@ -7,18 +7,17 @@
 #include "eBirdInterface.h"
 #include "email/cJSON/cJSON.h"
 #include "email/curlUtilities.h"
+#include "fnv1a.h"
 
 // Standard C++ headers
 #include <cctype>
 #include <algorithm>
 #include <map>
 #include <cassert>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
-
-const UString::String EBirdInterface::apiRoot(_T("https://api.ebird.org/v2/"));
-const UString::String EBirdInterface::observationDataPath(_T("data/obs/"));
-const UString::String EBirdInterface::recentNotableEndPoint(_T("/recent/notable"));
+#include <memory>
 
 const UString::String EBirdInterface::speciesCodeTag(_T("speciesCode"));
 const UString::String EBirdInterface::commonNameTag(_T("comName"));
@@ -44,6 +43,12 @@ const UString::String EBirdInterface::commentsTag(_T("comments"));// TODO:  Unve
 const UString::String EBirdInterface::hasMediaTag(_T("hasRichMedia"));
 const UString::String EBirdInterface::observationIDTag(_T("obsId"));
 
+const UString::String EBirdInterface::taxonOrderTag(_T("taxonOrder"));
+const UString::String EBirdInterface::orderTag(_T("order"));
+const UString::String EBirdInterface::familyCodeTag(_T("familyCode"));
+const UString::String EBirdInterface::familyCommonNameTag(_T("familyComName"));
+const UString::String EBirdInterface::familyScientificNameTag(_T("familySciName"));
+
 const UString::String EBirdInterface::nameTag(_T("name"));
 const UString::String EBirdInterface::codeTag(_T("code"));
 const UString::String EBirdInterface::resultTag(_T("result"));
@@ -52,12 +57,30 @@ const UString::String EBirdInterface::errorTag(_T("errors"));
 const UString::String EBirdInterface::titleTag(_T("title"));
 const UString::String EBirdInterface::statusTag(_T("status"));
 
-const UString::String EBirdInterface::eBirdTokenHeader(_T("X-eBirdApiToken: "));
-
 bool EBirdInterface::GetRecentNotableObservations(const UString::String& regionCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservations(BuildRecentNotableURL(regionCode, daysBack), true, observations);
+}
+
+bool EBirdInterface::GetRecentNotableObservations(const double& latitude, const double& longitude, const double& radius, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservations(BuildRecentNotableGeoURL(latitude, longitude, radius, daysBack), true, observations);
+}
+
+bool EBirdInterface::GetRecentSpeciesObservations(const UString::String& regionCode, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservations(BuildRecentSpeciesURL(regionCode, speciesCode, daysBack), false, observations);
+}
+
+bool EBirdInterface::GetRecentSpeciesObservations(const double& latitude, const double& longitude, const double& radius, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservations(BuildRecentSpeciesGeoURL(latitude, longitude, radius, speciesCode, daysBack), false, observations);
+}
+
+bool EBirdInterface::GetTaxonomy(std::vector<TaxonomyInfo>& taxonomy)
 {
 	UString::OStringStream request;
-	request << apiRoot << observationDataPath << regionCode << recentNotableEndPoint << "?back=" << daysBack << "&detail=full";
+	request << apiRootURL << taxonomyPath << "?fmt=json";
 
 	std::string response;
 	if (!DoCURLGet(URLEncode(request.str()), response, AddTokenToCurlHeader, &tokenData))
@@ -66,7 +89,141 @@ bool EBirdInterface::GetRecentNotableObservations(const UString::String& regionC
 	cJSON *root(cJSON_Parse(response.c_str()));
 	if (!root)
 	{
-		log << _T("Failed to parse returned string (GetRecentNotableObservations())\n");
+		log << _T("Failed to parse returned string (GetTaxonomy())\n");
+		return false;
+	}
+
+	std::vector<ErrorInfo> errorInfo;
+	if (ResponseHasErrors(root, errorInfo))
+	{
+		PrintErrorInfo(errorInfo);
+		cJSON_Delete(root);
+		return false;
+	}
+
+	taxonomy.resize(cJSON_GetArraySize(root));
+	unsigned int i(0);
+	for (auto& t : taxonomy)
+	{
+		cJSON* item(cJSON_GetArrayItem(root, i++));
+		if (!item || !ReadJSONTaxonomyData(item, t))
+		{
+			log << _T("Failed to read taxonomy entry ") << i << '\n';
+			cJSON_Delete(root);
+			return false;
+		}
+	}
+
+	cJSON_Delete(root);
+	return true;
+}
+
+Task<bool> EBirdInterface::GetRecentNotableObservationsAsync(AsyncCurl& loop, const UString::String& regionCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservationsAsync(loop, BuildRecentNotableURL(regionCode, daysBack), true, observations);
+}
+
+Task<bool> EBirdInterface::GetRecentNotableObservationsAsync(AsyncCurl& loop, const double& latitude, const double& longitude, const double& radius, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservationsAsync(loop, BuildRecentNotableGeoURL(latitude, longitude, radius, daysBack), true, observations);
+}
+
+Task<bool> EBirdInterface::GetRecentSpeciesObservationsAsync(AsyncCurl& loop, const UString::String& regionCode, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservationsAsync(loop, BuildRecentSpeciesURL(regionCode, speciesCode, daysBack), false, observations);
+}
+
+Task<bool> EBirdInterface::GetRecentSpeciesObservationsAsync(AsyncCurl& loop, const double& latitude, const double& longitude, const double& radius, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations)
+{
+	return FetchObservationsAsync(loop, BuildRecentSpeciesGeoURL(latitude, longitude, radius, speciesCode, daysBack), false, observations);
+}
+
+bool EBirdInterface::FetchObservations(const UString::String& url, const bool& detailed, std::vector<ObservationInfo>& observations)
+{
+	std::string response;
+	if (!DoCURLGet(URLEncode(url), response, AddTokenToCurlHeader, &tokenData))
+		return false;
+
+	const bool success(DecodeObservations(response, detailed, observations));
+	if (success && detailed)
+		ArchiveResponse(url, response);
+	return success;
+}
+
+Task<bool> EBirdInterface::FetchObservationsAsync(AsyncCurl& loop, const UString::String url, const bool detailed, std::vector<ObservationInfo>& observations)
+{
+	// curl doesn't copy the header list, so it's owned here until the transfer is finished (or abandoned)
+	const std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> headers(BuildHeaderList(tokenData.token), curl_slist_free_all);
+	const auto response(co_await loop.Get(URLEncode(url), [&headers](CURL* curl)
+	{
+		return headers && !CURLUtilities::CURLCallHasError(curl_easy_setopt(curl,
+			CURLOPT_HTTPHEADER, headers.get()), _T("Failed to set header"));
+	}));
+
+	if (!response.ok)
+		co_return false;
+
+	const bool success(DecodeObservations(response.body, detailed, observations));
+	if (success && detailed)
+		ArchiveResponse(url, response.body);
+	co_return success;
+}
+
+// Only detailed (recent/notable) responses are kept, since those are what replaying expects
+void EBirdInterface::ArchiveResponse(const UString::String& url, const std::string& response)
+{
+	if (!archive)
+		return;
+
+	// Name after the part of the URL that identifies the request
+	const UString::String prefix(apiRootURL + observationDataPath);
+	const UString::String name(url.compare(0, prefix.size(), prefix) == 0 ? url.substr(prefix.size()) : url);
+	archive->Save(UString::ToNarrowString(name), response);// Not fatal if this fails
+}
+
+UString::String EBirdInterface::BuildRecentNotableURL(const UString::String& regionCode, const unsigned int& daysBack) const
+{
+	UString::OStringStream request;
+	request << apiRootURL << observationDataPath << regionCode << recentNotableEndPoint << "?back=" << daysBack << "&detail=full";
+	return request.str();
+}
+
+UString::String EBirdInterface::BuildRecentNotableGeoURL(const double& latitude, const double& longitude, const double& radius, const unsigned int& daysBack) const
+{
+	UString::OStringStream request;
+	request << apiRootURL << observationDataPath << geoPath << recentNotableEndPoint << BuildGeoArguments(latitude, longitude, radius) << "&back=" << daysBack << "&detail=full";
+	return request.str();
+}
+
+UString::String EBirdInterface::BuildRecentSpeciesGeoURL(const double& latitude, const double& longitude, const double& radius, const UString::String& speciesCode, const unsigned int& daysBack) const
+{
+	UString::OStringStream request;
+	request << apiRootURL << observationDataPath << geoPath << recentEndPoint << '/' << speciesCode << BuildGeoArguments(latitude, longitude, radius) << "&back=" << daysBack << "&includeProvisional=true";
+	return request.str();
+}
+
+// eBird only accepts whole kilometers; round up so that nothing within the configured radius is missed
+UString::String EBirdInterface::BuildGeoArguments(const double& latitude, const double& longitude, const double& radius)
+{
+	UString::OStringStream ss;
+	ss << "?lat=" << std::fixed << std::setprecision(4) << latitude << "&lng=" << longitude << "&dist=" << std::max(1, static_cast<int>(std::ceil(radius)));
+	return ss.str();
+}
+
+UString::String EBirdInterface::BuildRecentSpeciesURL(const UString::String& regionCode, const UString::String& speciesCode, const unsigned int& daysBack) const
+{
+	UString::OStringStream request;
+	request << apiRootURL << observationDataPath << regionCode << recentEndPoint << '/' << speciesCode << "?back=" << daysBack << "&includeProvisional=true";
+	return request.str();
+}
+
+bool EBirdInterface::DecodeObservations(const std::string& response, const bool& detailed, std::vector<ObservationInfo>& observations)
+{
+	PollArena::CJSONScope cJSONScope(arena);
+	cJSON *root(cJSON_Parse(response.c_str()));
+	if (!root)
+	{
+		log << _T("Failed to parse returned string (DecodeObservations())\n");
 		log << response.c_str() << '\n';
 		return false;
 	}
@@ -75,6 +232,7 @@ bool EBirdInterface::GetRecentNotableObservations(const UString::String& regionC
 	if (ResponseHasErrors(root, errorInfo))
 	{
 		PrintErrorInfo(errorInfo);
+		cJSON_Delete(root);
 		return false;
 	}
 
@@ -90,9 +248,12 @@ bool EBirdInterface::GetRecentNotableObservations(const UString::String& regionC
 			return false;
 		}
 
-		if (!ReadJSONObservationData(item, o))
+		if (!ReadJSONObservationData(item, detailed, o))
 		{
-			log << cJSON_Print(root);
+			char* itemText(cJSON_Print(item));
+			if (itemText)
+				log << itemText << '\n';
+			cJSON_free(itemText);
 			cJSON_Delete(root);
 			return false;
 		}
@@ -100,6 +261,7 @@ bool EBirdInterface::GetRecentNotableObservations(const UString::String& regionC
 		++i;
 	}
 
+	cJSON_Delete(root);
 	return true;
 }
 
@@ -109,7 +271,7 @@ void EBirdInterface::PrintErrorInfo(const std::vector<ErrorInfo>& errors)
 		log << _T("Error ") << e.code << " : " << e.title << " : " << e.status << std::endl;
 }
 
-bool EBirdInterface::ReadJSONObservationData(cJSON* item, ObservationInfo& info)
+bool EBirdInterface::ReadJSONObservationData(cJSON* item, const bool& detailed, ObservationInfo& info)
 {
 	if (!ReadJSON(item, speciesCodeTag, info.speciesCode))
 	{
@@ -161,20 +323,25 @@ bool EBirdInterface::ReadJSONObservationData(cJSON* item, ObservationInfo& info)
 		info.dateIncludesTimeInfo = false;
 	}
 
-	if (!ReadJSON(item, presenceNotedTag, info.presenceNoted))
-	{
-		log << _T("Failed to read presence noted tag\n");
-		return false;
-	}
-
-	if (!info.presenceNoted)
+	if (detailed)
 	{
-		if (!ReadJSON(item, howManyTag, info.count))
+		if (!ReadJSON(item, presenceNotedTag, info.presenceNoted))
 		{
-			log << _T("Failed to get observation count\n");
+			log << _T("Failed to read presence noted tag\n");
 			return false;
 		}
+
+		if (!info.presenceNoted)
+		{
+			if (!ReadJSON(item, howManyTag, info.count))
+			{
+				log << _T("Failed to get observation count\n");
+				return false;
+			}
+		}
 	}
+	else// Simple format omits the count entirely when only presence was noted
+		info.presenceNoted = !ReadJSON(item, howManyTag, info.count);
 
 	if (!ReadJSON(item, latitudeTag, info.latitude))
 	{
@@ -212,13 +379,22 @@ bool EBirdInterface::ReadJSONObservationData(cJSON* item, ObservationInfo& info)
 		return false;
 	}
 
+	// The simple format has no observation ID, but a species can only appear once per checklist, so this
+	// identifies the same sighting whichever endpoint it came from
+	info.observationID = info.checklistID + info.speciesCode;
+	if (!detailed)
+	{
+		info.hasMedia = false;
+		return true;
+	}
+
 	if (!ReadJSON(item, userDisplayNameTag, info.userName))
 	{
 		log << _T("Failed to get user name\n");
 		return false;
 	}
 
-	if (!ReadJSON(item, observationIDTag, info.observationID))
+	if (!ReadJSON(item, observationIDTag, info.legacyObservationID))
 	{
 		log << _T("Failed to get observation ID\n");
 		return false;
@@ -249,24 +425,51 @@ bool EBirdInterface::ReadJSONObservationData(cJSON* item, ObservationInfo& info)
 	return true;
 }
 
-bool EBirdInterface::AddTokenToCurlHeader(CURL* curl, const ModificationData* data)
+bool EBirdInterface::ReadJSONTaxonomyData(cJSON* item, TaxonomyInfo& info)
 {
-	curl_slist* headerList(nullptr);
-	headerList = curl_slist_append(headerList, UString::ToNarrowString(UString::String(eBirdTokenHeader
-		+ static_cast<const TokenData*>(data)->token)).c_str());
-	if (!headerList)
+	if (!ReadJSON(item, speciesCodeTag, info.speciesCode))
 	{
-		std::cerr << "Failed to append token to header in AddTokenToCurlHeader\n";
+		log << _T("Failed to get species code\n");
 		return false;
 	}
 
-	headerList = curl_slist_append(headerList, "Content-Type: application/json");
-	if (!headerList)
+	if (!ReadJSON(item, commonNameTag, info.commonName))
 	{
-		std::cerr << "Failed to append content type to header in ListTables\n";
+		log << _T("Failed to get common name for item\n");
 		return false;
 	}
 
+	if (!ReadJSON(item, scientificNameTag, info.scientificName))
+	{
+		log << _T("Failed to get scientific name for item\n");
+		return false;
+	}
+
+	if (!ReadJSON(item, taxonOrderTag, info.taxonOrder))
+	{
+		log << _T("Failed to get taxon order for item\n");
+		return false;
+	}
+
+	// Not all taxa (e.g. some hybrids and spuhs) are assigned to an order or family
+	if (!ReadJSON(item, orderTag, info.order))
+		info.order.clear();
+	if (!ReadJSON(item, familyCodeTag, info.familyCode))
+		info.familyCode.clear();
+	if (!ReadJSON(item, familyCommonNameTag, info.familyCommonName))
+		info.familyCommonName.clear();
+	if (!ReadJSON(item, familyScientificNameTag, info.familyScientificName))
+		info.familyScientificName.clear();
+
+	return true;
+}
+
+bool EBirdInterface::AddTokenToCurlHeader(CURL* curl, const ModificationData* data)
+{
+	curl_slist* headerList(BuildHeaderList(static_cast<const TokenData*>(data)->token));
+	if (!headerList)
+		return false;
+
 	if (CURLUtilities::CURLCallHasError(curl_easy_setopt(curl,
 		CURLOPT_HTTPHEADER, headerList), _T("Failed to set header")))
 		return false;
@@ -274,6 +477,26 @@ bool EBirdInterface::AddTokenToCurlHeader(CURL* curl, const ModificationData* da
 	return true;
 }
 
+curl_slist* EBirdInterface::BuildHeaderList(const UString::String& token)
+{
+	curl_slist* headerList(curl_slist_append(nullptr, UString::ToNarrowString(UString::String(eBirdTokenHeader + token)).c_str()));
+	if (!headerList)
+	{
+		std::cerr << "Failed to append token to header in BuildHeaderList\n";
+		return nullptr;
+	}
+
+	curl_slist* withContentType(curl_slist_append(headerList, "Content-Type: application/json"));
+	if (!withContentType)
+	{
+		std::cerr << "Failed to append content type to header in BuildHeaderList\n";
+		curl_slist_free_all(headerList);
+		return nullptr;
+	}
+
+	return withContentType;
+}
+
 bool EBirdInterface::ResponseHasErrors(cJSON *root, std::vector<ErrorInfo>& errors)
 {
 	cJSON* errorsNode(cJSON_GetObjectItem(root, UString::ToNarrowString(errorTag).c_str()));
@@ -317,3 +540,23 @@ bool EBirdInterface::ObservationInfo::operator==(const ObservationInfo& o)
 {
 	return observationID == o.observationID;
 }
+
+uint64_t EBirdInterface::ObservationInfo::Fingerprint() const
+{
+	FNV1a hash;
+	auto addString([&hash](const UString::String& s)
+	{
+		hash.Add(s.data(), s.size() * sizeof(UString::Char));
+		hash.Add("", 1);// Separator, so adjacent fields can't run together
+	});
+
+	// Only fields that every endpoint returns, so that the same sighting gets the same fingerprint from
+	// a species watch as from a notable watch (the simple format has no media or comments)
+	addString(speciesCode);
+	const unsigned char flags((presenceNoted ? 1 : 0) | (observationReviewed ? 2 : 0) | (observationValid ? 4 : 0));
+	hash.Add(&flags, sizeof(flags));
+	const uint32_t c(presenceNoted ? 0 : count);
+	hash.Add(&c, sizeof(c));
+
+	return hash.Get() == 0 ? 1 : hash.Get();// Zero is reserved to mean "no fingerprint"
+}
@@ -9,11 +9,15 @@
 // Local headers
 #include "utilities/uString.h"
 #include "email/jsonInterface.h"
+#include "asyncCurl.h"
+#include "pollArena.h"
+#include "responseArchive.h"
 
 // Standard C++ headers
 #include <vector>
 #include <unordered_map>
 #include <ctime>
+#include <cstdint>
 
 class EBirdInterface : public JSONInterface
 {
@@ -40,22 +44,67 @@ public:
 		unsigned int duration = 0;// [min]
 		bool hasMedia;
 		UString::String comments;
-		UString::String observationID;
+		UString::String observationID;// Checklist ID + species code
+		UString::String legacyObservationID;// eBird's obsId (detailed format only); histories written by older versions are keyed by this
 		UString::String checklistID;
 		UString::String userName;
 
 		bool dateIncludesTimeInfo = true;
+		bool isUpdate = false;// Previously reported, but details have changed since
+		unsigned int reportCount = 1;// Number of reports of this bird this represents (see EventClusterer)
 
 		bool operator==(const ObservationInfo& o);
+
+		// Hash of the details that may change after an observation is first reported (review status and count)
+		uint64_t Fingerprint() const;
+	};
+
+	struct TaxonomyInfo
+	{
+		UString::String speciesCode;
+		UString::String commonName;
+		UString::String scientificName;
+		UString::String familyCode;
+		UString::String familyCommonName;
+		UString::String familyScientificName;
+		UString::String order;
+		double taxonOrder;
 	};
 
 	bool GetRecentNotableObservations(const UString::String& regionCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);
+	bool GetRecentNotableObservations(const double& latitude, const double& longitude, const double& radius, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);// radius in [km], max 50
+	bool GetRecentSpeciesObservations(const UString::String& regionCode, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);
+	bool GetRecentSpeciesObservations(const double& latitude, const double& longitude, const double& radius, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);
 
-private:
-	static const UString::String apiRoot;
-	static const UString::String observationDataPath;
-	static const UString::String recentNotableEndPoint;
+	bool GetTaxonomy(std::vector<TaxonomyInfo>& taxonomy);
+
+	// When set, JSON parsing scratch memory is taken from the arena instead of the heap
+	void SetArena(PollArena* pollArena) { arena = pollArena; }
 
+	// When set, raw recent/notable responses are saved to the archive
+	void SetResponseArchive(ResponseArchive* responseArchive) { archive = responseArchive; }
+
+	// Replaces the official API root (e.g. with a local mock server for testing); must end with '/'
+	void SetAPIRoot(const UString::String& root) { apiRootURL = root; }
+
+	// For responses to GetRecentNotableObservations() saved elsewhere (e.g. for replaying)
+	bool ParseRecentNotableObservations(const std::string& response, std::vector<ObservationInfo>& observations) { return DecodeObservations(response, true, observations); }
+
+	Task<bool> GetRecentNotableObservationsAsync(AsyncCurl& loop, const UString::String& regionCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);
+	Task<bool> GetRecentNotableObservationsAsync(AsyncCurl& loop, const double& latitude, const double& longitude, const double& radius, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);
+	Task<bool> GetRecentSpeciesObservationsAsync(AsyncCurl& loop, const UString::String& regionCode, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);
+	Task<bool> GetRecentSpeciesObservationsAsync(AsyncCurl& loop, const double& latitude, const double& longitude, const double& radius, const UString::String& speciesCode, const unsigned int& daysBack, std::vector<ObservationInfo>& observations);
+
+private:
+	static constexpr UString::Char apiRoot[] = _T("https://api.ebird.org/v2/");
+	static constexpr UString::Char observationDataPath[] = _T("data/obs/");
+	static constexpr UString::Char taxonomyPath[] = _T("ref/taxonomy/ebird");
+	static constexpr UString::Char geoPath[] = _T("geo");
+	static constexpr UString::Char recentEndPoint[] = _T("/recent");
+	static constexpr UString::Char recentNotableEndPoint[] = _T("/recent/notable");
+
+	// Kept as strings (rather than constexpr arrays like the URL pieces) because ReadJSON() takes
+	// strings, so an array would be converted for every field of every observation
 	static const UString::String speciesCodeTag;
 	static const UString::String commonNameTag;
 	static const UString::String scientificNameTag;
@@ -82,6 +131,12 @@ private:
 	static const UString::String hasMediaTag;
 	static const UString::String observationIDTag;
 
+	static const UString::String taxonOrderTag;
+	static const UString::String orderTag;
+	static const UString::String familyCodeTag;
+	static const UString::String familyCommonNameTag;
+	static const UString::String familyScientificNameTag;
+
 	static const UString::String nameTag;
 	static const UString::String codeTag;
 	static const UString::String resultTag;
@@ -90,9 +145,23 @@ private:
 	static const UString::String titleTag;
 	static const UString::String statusTag;
 
-	static const UString::String eBirdTokenHeader;
+	static constexpr UString::Char eBirdTokenHeader[] = _T("X-eBirdApiToken: ");
+
+	UString::String BuildRecentNotableURL(const UString::String& regionCode, const unsigned int& daysBack) const;
+	UString::String BuildRecentNotableGeoURL(const double& latitude, const double& longitude, const double& radius, const unsigned int& daysBack) const;
+	UString::String BuildRecentSpeciesURL(const UString::String& regionCode, const UString::String& speciesCode, const unsigned int& daysBack) const;
+	UString::String BuildRecentSpeciesGeoURL(const double& latitude, const double& longitude, const double& radius, const UString::String& speciesCode, const unsigned int& daysBack) const;
+	static UString::String BuildGeoArguments(const double& latitude, const double& longitude, const double& radius);
+
+	bool FetchObservations(const UString::String& url, const bool& detailed, std::vector<ObservationInfo>& observations);
+	// Arguments are copied into the coroutine frame since they must remain valid across suspension
+	Task<bool> FetchObservationsAsync(AsyncCurl& loop, const UString::String url, const bool detailed, std::vector<ObservationInfo>& observations);
 
-	bool ReadJSONObservationData(cJSON* item, ObservationInfo& info);
+	// The species endpoints only support the "simple" format, which omits several of the detailed fields
+	bool DecodeObservations(const std::string& response, const bool& detailed, std::vector<ObservationInfo>& observations);
+	bool ReadJSONObservationData(cJSON* item, const bool& detailed, ObservationInfo& info);
+	bool ReadJSONTaxonomyData(cJSON* item, TaxonomyInfo& info);
+	void ArchiveResponse(const UString::String& url, const std::string& response);
 
 	struct TokenData : public ModificationData
 	{
@@ -102,8 +171,12 @@ private:
 
 	const TokenData tokenData;
 	UString::OStream& log;
+	PollArena* arena = nullptr;
+	ResponseArchive* archive = nullptr;
+	UString::String apiRootURL = apiRoot;
 
 	static bool AddTokenToCurlHeader(CURL* curl, const ModificationData* data);// Expects TokenData
+	static curl_slist* BuildHeaderList(const UString::String& token);// Caller frees with curl_slist_free_all
 
 	struct ErrorInfo
 	{
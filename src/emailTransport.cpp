@@ -0,0 +1,17 @@
+// File:  emailTransport.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification transport for e-mail, either through the Gmail REST API or plain SMTP.
+
+// Local headers
+#include "emailTransport.h"
+
+bool EmailTransport::Send(const Message& message, UString::OStream& log)
+{
+	constexpr bool useHTML(true);
+	constexpr bool verbose(false);
+	EmailSender sender(message.subject, message.htmlBody, std::string(), recipients, loginInfo, useHTML, verbose, log);
+	if (protocol == Protocol::GmailREST)
+		return sender.SendREST();
+	return sender.Send();
+}
@@ -0,0 +1,38 @@
+// File:  emailTransport.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification transport for e-mail, either through the Gmail REST API or plain SMTP.
+
+#ifndef EMAIL_TRANSPORT_H_
+#define EMAIL_TRANSPORT_H_
+
+// Local headers
+#include "notificationTransport.h"
+#include "email/emailSender.h"
+
+// Standard C++ headers
+#include <vector>
+
+class EmailTransport : public NotificationTransport
+{
+public:
+	enum class Protocol
+	{
+		GmailREST,
+		SMTP
+	};
+
+	// All recipients are sent a single message (one session with the server)
+	EmailTransport(const Protocol& protocol, const EmailSender::LoginInfo& loginInfo, const std::vector<EmailSender::AddressInfo>& recipients)
+		: protocol(protocol), loginInfo(loginInfo), recipients(recipients) {}
+
+	std::string GetName() const override { return protocol == Protocol::GmailREST ? "gmail" : "smtp"; }
+	bool Send(const Message& message, UString::OStream& log) override;
+
+private:
+	const Protocol protocol;
+	const EmailSender::LoginInfo loginInfo;
+	const std::vector<EmailSender::AddressInfo> recipients;
+};
+
+#endif// EMAIL_TRANSPORT_H_
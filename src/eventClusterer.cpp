@@ -0,0 +1,167 @@
+// File:  eventClusterer.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Groups repeat reports of the same bird (same species, nearby, close in time) into events.
+
+// Local headers
+#include "eventClusterer.h"
+
+// Standard C++ headers
+#include <cmath>
+#include <algorithm>
+
+EventClusterer::EventClusterer(const double& distance, const std::chrono::hours& window, std::vector<Event> events)
+	: cellSize(distance / 111.0), window(std::chrono::duration_cast<std::chrono::seconds>(window).count()), events(std::move(events))
+{
+	for (unsigned int i = 0; i < this->events.size(); ++i)
+		AddToIndex(i);
+}
+
+std::vector<EBirdInterface::ObservationInfo> EventClusterer::Process(const std::vector<EBirdInterface::ObservationInfo>& observations)
+{
+	// For each event touched in this pass:  which observation represents it and whether it's worth reporting
+	struct Touched
+	{
+		unsigned int observation;
+		bool isNew;
+		bool changed;
+	};
+	std::unordered_map<unsigned int, Touched> touched;
+	std::vector<unsigned int> order;// Event indices in order first touched, so output follows input order
+
+	for (unsigned int i = 0; i < observations.size(); ++i)
+	{
+		const auto& o(observations[i]);
+		const auto species(UString::ToNarrowString(o.speciesCode));
+		const auto location(UString::ToNarrowString(o.locationID));
+		std::tm t(o.observationDate);
+		const int64_t time(static_cast<int64_t>(std::mktime(&t)));
+		const unsigned int count(o.presenceNoted ? 0 : o.count);
+
+		int32_t x, y;
+		GetCell(o.latitude, o.longitude, x, y);
+		int e(FindEvent(species, x, y, time));
+		bool isNew(false), changed(o.isUpdate);
+		if (e < 0)
+		{
+			Event event;
+			event.speciesCode = species;
+			event.cellX = x;
+			event.cellY = y;
+			event.firstSeen = time;
+			event.lastSeen = time;
+			event.reportCount = 0;
+			event.maxCount = count;
+			event.locationIDs.push_back(location);
+			events.push_back(std::move(event));
+			e = static_cast<int>(events.size() - 1);
+			AddToIndex(e);
+			isNew = true;
+		}
+		else
+		{
+			auto& event(events[e]);
+			if (count > event.maxCount)
+			{
+				event.maxCount = count;
+				changed = true;
+			}
+
+			if (std::find(event.locationIDs.begin(), event.locationIDs.end(), location) == event.locationIDs.end())
+			{
+				event.locationIDs.push_back(location);
+				changed = true;
+			}
+
+			event.firstSeen = std::min(event.firstSeen, time);
+			event.lastSeen = std::max(event.lastSeen, time);
+		}
+
+		if (!o.isUpdate)// Updates to a report we've already counted don't add a report
+			++events[e].reportCount;
+
+		auto it(touched.find(e));
+		if (it == touched.end())
+		{
+			touched.emplace(e, Touched{ i, isNew, changed });
+			order.push_back(e);
+			continue;
+		}
+
+		// Represent the event by its largest count, breaking ties with the most recent report
+		const auto& current(observations[it->second.observation]);
+		const unsigned int currentCount(current.presenceNoted ? 0 : current.count);
+		std::tm currentTime(current.observationDate);
+		if (count > currentCount || (count == currentCount && time > static_cast<int64_t>(std::mktime(&currentTime))))
+			it->second.observation = i;
+		it->second.changed = it->second.changed || changed;
+	}
+
+	std::vector<EBirdInterface::ObservationInfo> representatives;
+	for (const auto& e : order)
+	{
+		const auto& t(touched[e]);
+		if (!t.isNew && !t.changed)
+			continue;
+
+		representatives.push_back(observations[t.observation]);
+		representatives.back().reportCount = events[e].reportCount;
+		representatives.back().isUpdate = !t.isNew;
+	}
+
+	return representatives;
+}
+
+std::vector<EventClusterer::Event> EventClusterer::GetEvents(const int64_t& expireBefore) const
+{
+	std::vector<Event> current;
+	std::copy_if(events.begin(), events.end(), std::back_inserter(current), [&expireBefore](const Event& e)
+	{
+		return e.lastSeen >= expireBefore;
+	});
+	return current;
+}
+
+EventClusterer::CellKey EventClusterer::MakeKey(const int32_t& x, const int32_t& y)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void EventClusterer::GetCell(const double& latitude, const double& longitude, int32_t& x, int32_t& y) const
+{
+	// Scale longitude so cells are roughly square on the ground
+	const double pi(3.14159265358979323846);
+	y = static_cast<int32_t>(std::floor(latitude / cellSize));
+	x = static_cast<int32_t>(std::floor(longitude * std::cos((y + 0.5) * cellSize * pi / 180.0) / cellSize));
+}
+
+void EventClusterer::AddToIndex(const unsigned int& i)
+{
+	index[events[i].speciesCode][MakeKey(events[i].cellX, events[i].cellY)].push_back(i);
+}
+
+int EventClusterer::FindEvent(const std::string& speciesCode, const int32_t& x, const int32_t& y, const int64_t& time) const
+{
+	const auto speciesIndex(index.find(speciesCode));
+	if (speciesIndex == index.end())
+		return -1;
+
+	// Check neighboring cells too, so a bird near a cell boundary isn't split into two events
+	for (int32_t dx = -1; dx <= 1; ++dx)
+	{
+		for (int32_t dy = -1; dy <= 1; ++dy)
+		{
+			const auto cell(speciesIndex->second.find(MakeKey(x + dx, y + dy)));
+			if (cell == speciesIndex->second.end())
+				continue;
+
+			for (const auto& e : cell->second)
+			{
+				if (time >= events[e].firstSeen - window && time <= events[e].lastSeen + window)
+					return static_cast<int>(e);
+			}
+		}
+	}
+
+	return -1;
+}
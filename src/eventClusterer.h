@@ -0,0 +1,58 @@
+// File:  eventClusterer.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Groups repeat reports of the same bird (same species, nearby, close in time) into events.
+
+#ifndef EVENT_CLUSTERER_H_
+#define EVENT_CLUSTERER_H_
+
+// Local headers
+#include "eBirdInterface.h"
+
+// Standard C++ headers
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+class EventClusterer
+{
+public:
+	struct Event
+	{
+		std::string speciesCode;
+		int32_t cellX;
+		int32_t cellY;
+		int64_t firstSeen;// Observation times [sec since epoch]
+		int64_t lastSeen;
+		unsigned int reportCount;
+		unsigned int maxCount;
+		std::vector<std::string> locationIDs;
+	};
+
+	// distance [km] is the grid cell size; reports in the same or adjacent cells whose times are within window belong to the same event
+	EventClusterer(const double& distance, const std::chrono::hours& window, std::vector<Event> events);
+
+	// Returns one observation per event that is new or has changed (higher count or a new location),
+	// with reportCount set to the event's total.  Follow-ups on known events are marked as updates.
+	std::vector<EBirdInterface::ObservationInfo> Process(const std::vector<EBirdInterface::ObservationInfo>& observations);
+
+	// Events last seen before expireBefore are dropped
+	std::vector<Event> GetEvents(const int64_t& expireBefore) const;
+
+private:
+	const double cellSize;// [deg]
+	const int64_t window;// [sec]
+	std::vector<Event> events;
+
+	typedef uint64_t CellKey;
+	std::unordered_map<std::string, std::unordered_map<CellKey, std::vector<unsigned int>>> index;// species -> cell -> event indices
+
+	static CellKey MakeKey(const int32_t& x, const int32_t& y);
+	void GetCell(const double& latitude, const double& longitude, int32_t& x, int32_t& y) const;
+	void AddToIndex(const unsigned int& i);
+	int FindEvent(const std::string& speciesCode, const int32_t& x, const int32_t& y, const int64_t& time) const;
+};
+
+#endif// EVENT_CLUSTERER_H_
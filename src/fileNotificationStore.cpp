@@ -0,0 +1,542 @@
+// File:  fileNotificationStore.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification store kept in local (or network-mounted) files.
+
+// Local headers
+#include "fileNotificationStore.h"
+#include "compressedFile.h"
+
+// Standard C++ headers
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+namespace fs = std::filesystem;
+
+bool FileNotificationStore::Read(std::vector<ReportedObservation>& observations)
+{
+	return ReadReportedObservations(nullptr, observations);
+}
+
+bool FileNotificationStore::Read(const std::unordered_set<std::string>& observationIds, std::vector<ReportedObservation>& observations)
+{
+	return ReadReportedObservations(&observationIds, observations);
+}
+
+// Reads everything if observationIds is nullptr
+bool FileNotificationStore::ReadReportedObservations(const std::unordered_set<std::string>* observationIds, std::vector<ReportedObservation>& observations)
+{
+	if (fileName.empty())
+		return true;
+
+	// If the file doesn't exist, don't treat is as an error because it wouldn't have been written yet on first execution of the application
+	if (!fs::exists(fileName))
+		return true;
+
+	std::unordered_map<std::string, size_t> indices;// Later records for the same observation replace earlier ones
+	bool parsed(true);
+	std::string id;
+	auto processLine([this, &observationIds, &observations, &indices, &parsed, &id](const std::string& line)
+	{
+		// Check the ID before parsing the rest so that skipping a record is cheap
+		if (observationIds)
+		{
+			id.assign(line, 0, line.find(','));
+			if (observationIds->find(id) == observationIds->end())
+				return true;
+		}
+
+		ReportedObservation o;
+		if (!line.empty() && line.back() == '\r')// Written in text mode on Windows
+		{
+			if (!ParseReportedObservationLine(line.substr(0, line.size() - 1), o))
+				return parsed = false;
+		}
+		else if (!ParseReportedObservationLine(line, o))
+			return parsed = false;
+
+		const auto index(indices.emplace(o.observationId, observations.size()));
+		if (index.second)
+			observations.push_back(std::move(o));
+		else
+			observations[index.first->second] = std::move(o);
+		return true;
+	});
+
+	if (!CompressedFile::ReadLines(fileName, processLine) && parsed)
+	{
+		log << "Failed to read '" << UString::ToStringType(fileName) << "'\n";
+		return false;
+	}
+
+	return parsed;
+}
+
+bool FileNotificationStore::ParseReportedObservationLine(const std::string& line, ReportedObservation& o)
+{
+	std::istringstream ss(line);
+	if (!std::getline(ss, o.observationId, ','))
+	{
+		log << "Failed to parse ID from observation line\n";
+		return false;
+	}
+
+	if (!std::getline(ss, o.observationDate, ','))
+	{
+		log << "Failed to parse date from observation line\n";
+		return false;
+	}
+
+	// Fingerprint is optional for compatibility with files written before it was added
+	std::string fingerprint;
+	if (std::getline(ss, fingerprint, ',') && !fingerprint.empty())
+	{
+		std::istringstream fingerprintStream(fingerprint);
+		if ((fingerprintStream >> std::hex >> o.fingerprint).fail())
+		{
+			log << "Failed to parse fingerprint from observation line\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FileNotificationStore::Write(const std::vector<ReportedObservation>& observations)
+{
+	if (fileName.empty())
+		return true;
+
+	if (!CompressedFile::Write(fileName, FormatReportedObservations(observations), compress))
+	{
+		log << "Failed to write '" << UString::ToStringType(fileName) << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+bool FileNotificationStore::Append(const std::vector<ReportedObservation>& observations)
+{
+	if (fileName.empty())
+		return true;
+
+	// Stay consistent with what's already there; a plain history becomes compressed when it's next rewritten
+	const bool compressAppended(fs::exists(fileName) ? CompressedFile::IsCompressed(fileName) : compress);
+	if (!CompressedFile::Append(fileName, FormatReportedObservations(observations), compressAppended))
+	{
+		log << "Failed to write '" << UString::ToStringType(fileName) << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+std::string FileNotificationStore::FormatReportedObservations(const std::vector<ReportedObservation>& observations)
+{
+	std::ostringstream ss;
+	for (const auto& o : observations)
+		ss << o.observationId << "," << o.observationDate << "," << std::hex << o.fingerprint << std::dec << '\n';
+	return ss.str();
+}
+
+bool FileNotificationStore::ReadFilter(BloomFilter& filter)
+{
+	if (fileName.empty() || !fs::exists(fileName))
+		return false;
+
+	// Filter is only trusted if the history is exactly as it was when the filter was written
+	uint64_t historySize;
+	std::error_code ec;
+	return filter.Read(GetFilterFileName(), historySize) && historySize == fs::file_size(fileName, ec) && !ec;
+}
+
+bool FileNotificationStore::WriteFilter(const BloomFilter& filter)
+{
+	if (fileName.empty())
+		return true;
+
+	std::error_code ec;
+	const uint64_t historySize(fs::file_size(fileName, ec));
+	if (ec || !filter.Write(GetFilterFileName(), historySize))
+	{
+		log << "Failed to write '" << UString::ToStringType(GetFilterFileName()) << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+bool FileNotificationStore::ReadEvents(std::vector<EventClusterer::Event>& events)
+{
+	if (fileName.empty() || !fs::exists(GetEventFileName()))
+		return true;
+
+	std::ifstream file(GetEventFileName());
+	if (!file.is_open())
+	{
+		log << "Failed to open '" << UString::ToStringType(GetEventFileName()) << "' for input\n";
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		EventClusterer::Event e;
+		if (!ParseEventLine(line, e))
+		{
+			log << "Failed to parse event line '" << UString::ToStringType(line) << "'\n";
+			return false;
+		}
+		events.push_back(std::move(e));
+	}
+
+	return true;
+}
+
+// Format is species,cellX,cellY,firstSeen,lastSeen,reportCount,maxCount,location[ location...]
+bool FileNotificationStore::ParseEventLine(const std::string& line, EventClusterer::Event& e)
+{
+	std::istringstream ss(line);
+	char c1, c2, c3, c4, c5, c6;
+	if (!std::getline(ss, e.speciesCode, ',') ||
+		!(ss >> e.cellX >> c1 >> e.cellY >> c2 >> e.firstSeen >> c3 >> e.lastSeen >> c4 >> e.reportCount >> c5 >> e.maxCount >> c6) ||
+		c1 != ',' || c2 != ',' || c3 != ',' || c4 != ',' || c5 != ',' || c6 != ',')
+		return false;
+
+	std::string location;
+	while (ss >> location)
+		e.locationIDs.push_back(location);
+
+	return true;
+}
+
+bool FileNotificationStore::WriteEvents(const std::vector<EventClusterer::Event>& events)
+{
+	if (fileName.empty())
+		return true;
+
+	std::ostringstream ss;
+	for (const auto& e : events)
+	{
+		ss << e.speciesCode << ',' << e.cellX << ',' << e.cellY << ',' << e.firstSeen << ',' << e.lastSeen << ','
+			<< e.reportCount << ',' << e.maxCount << ',';
+		for (unsigned int i = 0; i < e.locationIDs.size(); ++i)
+			ss << (i > 0 ? " " : "") << e.locationIDs[i];
+		ss << '\n';
+	}
+
+	if (!WriteFileAtomically(GetEventFileName(), ss.str()))
+	{
+		log << "Failed to write '" << UString::ToStringType(GetEventFileName()) << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+bool FileNotificationStore::ReadPendingDeliveries(std::vector<NotificationDispatcher::Delivery>& deliveries)
+{
+	if (fileName.empty() || !fs::exists(GetOutboxFileName()))
+		return true;
+
+	std::ifstream file(GetOutboxFileName());
+	if (!file.is_open())
+	{
+		log << "Failed to open '" << UString::ToStringType(GetOutboxFileName()) << "' for input\n";
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		NotificationDispatcher::Delivery d;
+		if (!ParseDeliveryLine(line, d))
+		{
+			log << "Failed to parse pending delivery in '" << UString::ToStringType(GetOutboxFileName()) << "'\n";
+			return false;
+		}
+		deliveries.push_back(std::move(d));
+	}
+
+	return true;
+}
+
+// Format is queued<tab>transport<tab>subject<tab>text<tab>html, with tabs, line breaks and backslashes in the fields escaped
+bool FileNotificationStore::ParseDeliveryLine(const std::string& line, NotificationDispatcher::Delivery& d)
+{
+	std::istringstream ss(line);
+	std::string queued, transport, subject, text, html;
+	if (!std::getline(ss, queued, '\t') || !std::getline(ss, transport, '\t') || !std::getline(ss, subject, '\t') ||
+		!std::getline(ss, text, '\t') || !std::getline(ss, html))
+		return false;
+
+	std::istringstream queuedStream(queued);
+	return !(queuedStream >> d.queued).fail() &&
+		UnescapeField(transport, d.transport) &&
+		UnescapeField(subject, d.message.subject) &&
+		UnescapeField(text, d.message.textBody) &&
+		UnescapeField(html, d.message.htmlBody);
+}
+
+bool FileNotificationStore::WritePendingDeliveries(const std::vector<NotificationDispatcher::Delivery>& deliveries)
+{
+	if (fileName.empty())
+		return true;
+
+	std::ostringstream ss;
+	for (const auto& d : deliveries)
+		ss << d.queued << '\t' << EscapeField(d.transport) << '\t' << EscapeField(d.message.subject) << '\t'
+			<< EscapeField(d.message.textBody) << '\t' << EscapeField(d.message.htmlBody) << '\n';
+
+	if (!WriteFileAtomically(GetOutboxFileName(), ss.str()))
+	{
+		log << "Failed to write '" << UString::ToStringType(GetOutboxFileName()) << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+std::string FileNotificationStore::EscapeField(const std::string& s)
+{
+	std::string escaped;
+	escaped.reserve(s.size());
+	for (const char& c : s)
+	{
+		if (c == '\\')
+			escaped += "\\\\";
+		else if (c == '\t')
+			escaped += "\\t";
+		else if (c == '\n')
+			escaped += "\\n";
+		else if (c == '\r')
+			escaped += "\\r";
+		else
+			escaped += c;
+	}
+	return escaped;
+}
+
+bool FileNotificationStore::UnescapeField(const std::string& s, std::string& unescaped)
+{
+	unescaped.clear();
+	unescaped.reserve(s.size());
+	for (size_t i = 0; i < s.size(); ++i)
+	{
+		if (s[i] != '\\')
+		{
+			unescaped += s[i];
+			continue;
+		}
+
+		if (++i == s.size())
+			return false;
+
+		if (s[i] == '\\')
+			unescaped += '\\';
+		else if (s[i] == 't')
+			unescaped += '\t';
+		else if (s[i] == 'n')
+			unescaped += '\n';
+		else if (s[i] == 'r')
+			unescaped += '\r';
+		else
+			return false;
+	}
+	return true;
+}
+
+bool FileNotificationStore::ReadFetchTimes(std::unordered_map<std::string, int64_t>& times)
+{
+	if (fileName.empty())
+		return true;
+
+	std::ifstream file(GetFetchTimeFileName());
+	if (!file.is_open())
+		return true;// Nothing fetched yet
+
+	// Format is <time> <watch key>; keys may contain spaces, so the key is the rest of the line
+	int64_t t;
+	std::string key;
+	while (file >> t && std::getline(file >> std::ws, key))
+		times[key] = t;
+
+	return !file.bad();
+}
+
+bool FileNotificationStore::WriteFetchTimes(const std::unordered_map<std::string, int64_t>& times)
+{
+	if (fileName.empty())
+		return true;
+
+	std::ostringstream ss;
+	for (const auto& t : times)
+		ss << t.second << ' ' << t.first << '\n';
+
+	if (!WriteFileAtomically(GetFetchTimeFileName(), ss.str()))
+	{
+		log << "Failed to write '" << UString::ToStringType(GetFetchTimeFileName()) << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+bool FileNotificationStore::TryLock(const std::string& owner, const std::chrono::seconds& lease)
+{
+	const std::string lockFileName(GetLockFileName());
+	std::string currentOwner;
+	long long expires;
+	if (ReadLock(lockFileName, currentOwner, expires))
+	{
+		if (currentOwner == owner && expires > Now())
+			return RenewLock(owner, lease);
+
+		// An expired lease of our own is re-taken like any other, since another worker may be breaking it
+		if (currentOwner != owner)
+		{
+			if (expires > Now())
+				return false;
+			log << "Breaking expired lock held by " << UString::ToStringType(currentOwner) << std::endl;
+		}
+
+		if (!RemoveLock(owner, currentOwner, expires))
+			return false;
+	}
+
+	// Exclusive creation fails if another worker got there first
+	FILE* file(std::fopen(lockFileName.c_str(), "wx"));
+	if (!file)
+		return false;
+
+	const std::string contents(owner + ' ' + std::to_string(Now() + lease.count()));
+	const bool ok(std::fwrite(contents.data(), 1, contents.size(), file) == contents.size());
+	if (std::fclose(file) != 0 || !ok)
+	{
+		std::remove(lockFileName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+void FileNotificationStore::Unlock(const std::string& owner)
+{
+	std::string currentOwner;
+	long long expires;
+	if (ReadLock(GetLockFileName(), currentOwner, expires) && currentOwner == owner)
+		RemoveLock(owner, currentOwner, expires);
+}
+
+// Replaced in place, so there is never a moment without a lock file for another worker to take.  Nobody
+// else touches a lease that hasn't expired, so once it's confirmed to still be ours it can't change before
+// the rename.
+bool FileNotificationStore::RenewLock(const std::string& owner, const std::chrono::seconds& lease)
+{
+	const std::string lockFileName(GetLockFileName());
+	const std::string tempName(lockFileName + ".renew." + owner);
+	{
+		std::ofstream file(tempName);
+		if (!file.is_open() || !(file << owner << ' ' << Now() + lease.count()))
+		{
+			std::remove(tempName.c_str());
+			return false;
+		}
+	}
+
+	std::string currentOwner;
+	long long expires;
+	if (ReadLock(lockFileName, currentOwner, expires) && currentOwner == owner && expires > Now())
+	{
+		std::error_code ec;
+		fs::rename(tempName, lockFileName, ec);
+		if (!ec)
+			return true;
+	}
+
+	std::remove(tempName.c_str());
+	return false;
+}
+
+// The lock may change between reading it and acting on it (e.g. if our lease expired and another
+// worker took over), so it's first renamed out of the way, which only one worker can do, and then
+// checked.  If what we moved turns out not to be the lease we read, it's put back.
+bool FileNotificationStore::RemoveLock(const std::string& owner, const std::string& expectedOwner, const long long& expectedExpires)
+{
+	const std::string lockFileName(GetLockFileName());
+	const std::string movedName(lockFileName + '.' + owner);
+	std::error_code ec;
+	fs::rename(lockFileName, movedName, ec);
+	if (ec)
+		return false;
+
+	std::string movedOwner;
+	long long movedExpires;
+	const bool expected(ReadLock(movedName, movedOwner, movedExpires) && movedOwner == expectedOwner && movedExpires == expectedExpires);
+	if (!expected)
+		fs::create_hard_link(movedName, lockFileName, ec);// Fails (harmlessly) if someone has already re-locked
+	fs::remove(movedName, ec);
+	return expected;
+}
+
+bool FileNotificationStore::Heartbeat(const std::string& worker)
+{
+	std::error_code ec;
+	fs::create_directories(GetWorkerDirectory(), ec);
+	if (ec)
+	{
+		log << "Failed to create '" << UString::ToStringType(GetWorkerDirectory()) << "'" << std::endl;
+		return false;
+	}
+
+	return WriteFileAtomically((fs::path(GetWorkerDirectory()) / worker).string(), std::to_string(Now()));
+}
+
+bool FileNotificationStore::GetLiveWorkers(const std::chrono::seconds& lease, std::vector<std::string>& workers)
+{
+	workers.clear();
+	std::error_code ec;
+	for (const auto& entry : fs::directory_iterator(GetWorkerDirectory(), ec))
+	{
+		if (!entry.is_regular_file() || entry.path().extension() == ".tmp")
+			continue;
+
+		std::ifstream file(entry.path());
+		long long lastSeen;
+		if (!(file >> lastSeen))
+			continue;
+
+		if (Now() - lastSeen < lease.count())
+			workers.push_back(entry.path().filename().string());
+	}
+
+	return !ec;
+}
+
+bool FileNotificationStore::ReadLock(const std::string& lockFileName, std::string& owner, long long& expires)
+{
+	std::ifstream file(lockFileName);
+	return file.is_open() && static_cast<bool>(file >> owner >> expires);
+}
+
+bool FileNotificationStore::WriteFileAtomically(const std::string& name, const std::string& contents)
+{
+	const std::string tempName(name + ".tmp");
+	{
+		std::ofstream file(tempName);
+		if (!file.is_open() || !(file << contents))
+			return false;
+	}
+
+	std::error_code ec;
+	fs::rename(tempName, name, ec);
+	return !ec;
+}
+
+long long FileNotificationStore::Now()
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,75 @@
+// File:  fileNotificationStore.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification store kept in local (or network-mounted) files.
+
+#ifndef FILE_NOTIFICATION_STORE_H_
+#define FILE_NOTIFICATION_STORE_H_
+
+// Local headers
+#include "notificationStore.h"
+#include "utilities/uString.h"
+
+class FileNotificationStore : public NotificationStore
+{
+public:
+	// An empty file name disables storage (reads return nothing and writes are discarded)
+	FileNotificationStore(const std::string& fileName, UString::OStream& log) : fileName(fileName), log(log) {}
+
+	// Compresses the history as it's written; compressed and uncompressed histories are both read
+	void SetCompression(const bool& compressHistory) { compress = compressHistory; }
+
+	bool Read(std::vector<ReportedObservation>& observations) override;
+	bool Read(const std::unordered_set<std::string>& observationIds, std::vector<ReportedObservation>& observations) override;
+	bool Write(const std::vector<ReportedObservation>& observations) override;
+	bool Append(const std::vector<ReportedObservation>& observations) override;
+
+	bool ReadFilter(BloomFilter& filter) override;
+	bool WriteFilter(const BloomFilter& filter) override;
+
+	// Events are in <fileName>.events
+	bool ReadEvents(std::vector<EventClusterer::Event>& events) override;
+	bool WriteEvents(const std::vector<EventClusterer::Event>& events) override;
+
+	// Pending deliveries are in <fileName>.outbox
+	bool ReadPendingDeliveries(std::vector<NotificationDispatcher::Delivery>& deliveries) override;
+	bool WritePendingDeliveries(const std::vector<NotificationDispatcher::Delivery>& deliveries) override;
+
+	// Fetch times are in <fileName>.fetched
+	bool ReadFetchTimes(std::unordered_map<std::string, int64_t>& times) override;
+	bool WriteFetchTimes(const std::unordered_map<std::string, int64_t>& times) override;
+
+	// Lock is <fileName>.lock; heartbeats are one file per worker in <fileName>.workers/
+	bool TryLock(const std::string& owner, const std::chrono::seconds& lease) override;
+	void Unlock(const std::string& owner) override;
+	bool Heartbeat(const std::string& worker) override;
+	bool GetLiveWorkers(const std::chrono::seconds& lease, std::vector<std::string>& workers) override;
+
+private:
+	const std::string fileName;
+	UString::OStream& log;
+	bool compress = false;
+
+	bool ReadReportedObservations(const std::unordered_set<std::string>* observationIds, std::vector<ReportedObservation>& observations);
+	bool ParseReportedObservationLine(const std::string& line, ReportedObservation& o);
+	static std::string FormatReportedObservations(const std::vector<ReportedObservation>& observations);
+	static bool ParseEventLine(const std::string& line, EventClusterer::Event& e);
+	static bool ParseDeliveryLine(const std::string& line, NotificationDispatcher::Delivery& d);
+	static std::string EscapeField(const std::string& s);
+	static bool UnescapeField(const std::string& s, std::string& unescaped);
+
+	std::string GetFilterFileName() const { return fileName + ".bloom"; }
+	std::string GetEventFileName() const { return fileName + ".events"; }
+	std::string GetFetchTimeFileName() const { return fileName + ".fetched"; }
+	std::string GetOutboxFileName() const { return fileName + ".outbox"; }
+	std::string GetLockFileName() const { return fileName + ".lock"; }
+	std::string GetWorkerDirectory() const { return fileName + ".workers"; }
+
+	static bool ReadLock(const std::string& lockFileName, std::string& owner, long long& expires);
+	bool RenewLock(const std::string& owner, const std::chrono::seconds& lease);
+	bool RemoveLock(const std::string& owner, const std::string& expectedOwner, const long long& expectedExpires);
+	static bool WriteFileAtomically(const std::string& name, const std::string& contents);
+	static long long Now();
+};
+
+#endif// FILE_NOTIFICATION_STORE_H_
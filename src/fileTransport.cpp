@@ -0,0 +1,36 @@
+// File:  fileTransport.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification transport that appends messages to a local file (or writes them to stdout).
+//        Useful as a stand-in for real channels when testing.
+
+// Local headers
+#include "fileTransport.h"
+
+// Standard C++ headers
+#include <fstream>
+#include <iostream>
+
+bool FileTransport::Send(const Message& message, UString::OStream& log)
+{
+	if (fileName == "-")
+	{
+		Write(std::cout, message);
+		return static_cast<bool>(std::cout.flush());
+	}
+
+	std::ofstream file(fileName, std::ios::app);
+	if (!file.is_open())
+	{
+		log << "Failed to open '" << UString::ToStringType(fileName) << "' for output\n";
+		return false;
+	}
+
+	Write(file, message);
+	return static_cast<bool>(file.flush());
+}
+
+void FileTransport::Write(std::ostream& out, const Message& message)
+{
+	out << "Subject: " << message.subject << "\n\n" << message.textBody << "\n\n";
+}
@@ -0,0 +1,28 @@
+// File:  fileTransport.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification transport that appends messages to a local file (or writes them to stdout).
+//        Useful as a stand-in for real channels when testing.
+
+#ifndef FILE_TRANSPORT_H_
+#define FILE_TRANSPORT_H_
+
+// Local headers
+#include "notificationTransport.h"
+
+class FileTransport : public NotificationTransport
+{
+public:
+	// A file name of "-" writes to stdout
+	explicit FileTransport(const std::string& fileName) : fileName(fileName) {}
+
+	std::string GetName() const override { return "file " + fileName; }
+	bool Send(const Message& message, UString::OStream& log) override;
+
+private:
+	const std::string fileName;
+
+	static void Write(std::ostream& out, const Message& message);
+};
+
+#endif// FILE_TRANSPORT_H_
@@ -0,0 +1,51 @@
+// File:  fnv1a.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  64-bit FNV-1a hash, for keys whose hashes are stored or shared between processes
+//        (unlike std::hash, the result is the same on every run and platform).
+
+#ifndef FNV1A_H_
+#define FNV1A_H_
+
+// Standard C++ headers
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+class FNV1a
+{
+public:
+	void Add(const void* data, const size_t& size)
+	{
+		const unsigned char* bytes(static_cast<const unsigned char*>(data));
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	void Add(const std::string_view& s) { Add(s.data(), s.size()); }
+	uint64_t Get() const { return hash; }
+
+	static uint64_t Hash(const std::string_view& s)
+	{
+		FNV1a h;
+		h.Add(s);
+		return h.Get();
+	}
+
+	// Final avalanche step (from MurmurHash3) so that similar keys (e.g. adjacent county codes) spread out
+	static uint64_t Mix(uint64_t h)
+	{
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		return h;
+	}
+
+private:
+	uint64_t hash = 14695981039346656037ull;
+};
+
+#endif// FNV1A_H_
@@ -0,0 +1,91 @@
+// File:  notificationDispatcher.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Delivers messages over several transports at once, retrying each independently.
+
+// Local headers
+#include "notificationDispatcher.h"
+
+// Standard C++ headers
+#include <future>
+#include <thread>
+
+const std::chrono::seconds NotificationDispatcher::initialRetryDelay(5);
+
+std::vector<std::string> NotificationDispatcher::GetTransportNames() const
+{
+	std::vector<std::string> names;
+	for (const auto& t : transports)
+		names.push_back(t->GetName());
+	return names;
+}
+
+std::vector<NotificationDispatcher::Delivery> NotificationDispatcher::Deliver(const std::vector<Delivery>& deliveries)
+{
+	std::vector<std::vector<const Delivery*>> transportDeliveries(transports.size());
+	for (const auto& d : deliveries)
+	{
+		for (unsigned int i = 0; i < transports.size(); ++i)
+		{
+			if (transports[i]->GetName() == d.transport)
+			{
+				transportDeliveries[i].push_back(&d);
+				break;
+			}
+		}
+	}
+
+	// Logs are collected per transport and written once everything is done, so output from different channels isn't interleaved
+	std::vector<UString::OStringStream> transportLogs(transports.size());
+	std::vector<std::future<size_t>> results;
+	for (unsigned int i = 0; i < transports.size(); ++i)
+		results.push_back(std::async(std::launch::async, &NotificationDispatcher::DeliverInOrder, this,
+			std::ref(*transports[i]), std::cref(transportDeliveries[i]), std::ref(transportLogs[i])));
+
+	std::vector<Delivery> undelivered;
+	for (unsigned int i = 0; i < transports.size(); ++i)
+	{
+		const size_t delivered(results[i].get());
+		log << transportLogs[i].str();
+		if (delivered == transportDeliveries[i].size())
+			continue;
+
+		log << "Failed to deliver " << transportDeliveries[i].size() - delivered << " notification(s) via "
+			<< UString::ToStringType(transports[i]->GetName()) << std::endl;
+		for (size_t j = delivered; j < transportDeliveries[i].size(); ++j)
+			undelivered.push_back(*transportDeliveries[i][j]);
+	}
+
+	return undelivered;
+}
+
+// Returns the number delivered
+size_t NotificationDispatcher::DeliverInOrder(NotificationTransport& transport, const std::vector<const Delivery*>& deliveries, UString::OStream& transportLog) const
+{
+	for (size_t i = 0; i < deliveries.size(); ++i)
+	{
+		if (!DeliverWithRetry(transport, deliveries[i]->message, transportLog))
+			return i;
+	}
+
+	return deliveries.size();
+}
+
+bool NotificationDispatcher::DeliverWithRetry(NotificationTransport& transport, const NotificationTransport::Message& message, UString::OStream& transportLog) const
+{
+	auto delay(initialRetryDelay);
+	for (unsigned int i = 0; i < attempts; ++i)
+	{
+		if (i > 0)
+		{
+			transportLog << "Retrying delivery via " << UString::ToStringType(transport.GetName()) << " in " << delay.count() << " sec" << std::endl;
+			std::this_thread::sleep_for(delay);
+			delay *= 2;
+		}
+
+		if (transport.Send(message, transportLog))
+			return true;
+	}
+
+	return false;
+}
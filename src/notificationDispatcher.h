@@ -0,0 +1,51 @@
+// File:  notificationDispatcher.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Delivers messages over several transports at once, retrying each independently.
+
+#ifndef NOTIFICATION_DISPATCHER_H_
+#define NOTIFICATION_DISPATCHER_H_
+
+// Local headers
+#include "notificationTransport.h"
+
+// Standard C++ headers
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+class NotificationDispatcher
+{
+public:
+	NotificationDispatcher(const unsigned int& attempts, UString::OStream& log) : attempts(attempts), log(log) {}
+
+	void Add(std::unique_ptr<NotificationTransport> transport) { transports.push_back(std::move(transport)); }
+	std::vector<std::string> GetTransportNames() const;
+
+	struct Delivery
+	{
+		std::string transport;// As returned by NotificationTransport::GetName()
+		int64_t queued;// [sec since epoch] when first attempted
+		NotificationTransport::Message message;
+	};
+
+	// Each transport is given its own thread, so a slow or failing channel doesn't hold up the others.  A transport's
+	// deliveries are made in order, stopping at the first that fails.  Returns the deliveries that weren't made, so that
+	// they can be tried again later over just the transports that still owe them.  Deliveries for transports that
+	// weren't added are ignored.
+	std::vector<Delivery> Deliver(const std::vector<Delivery>& deliveries);
+
+private:
+	const unsigned int attempts;
+	UString::OStream& log;
+	std::vector<std::unique_ptr<NotificationTransport>> transports;
+
+	static const std::chrono::seconds initialRetryDelay;
+
+	size_t DeliverInOrder(NotificationTransport& transport, const std::vector<const Delivery*>& deliveries, UString::OStream& transportLog) const;
+	bool DeliverWithRetry(NotificationTransport& transport, const NotificationTransport::Message& message, UString::OStream& transportLog) const;
+};
+
+#endif// NOTIFICATION_DISPATCHER_H_
@@ -0,0 +1,67 @@
+// File:  notificationStore.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Interface to storage for the set of already-notified observations, possibly
+//        shared between several workers.
+
+#ifndef NOTIFICATION_STORE_H_
+#define NOTIFICATION_STORE_H_
+
+// Local headers
+#include "bloomFilter.h"
+#include "eventClusterer.h"
+#include "notificationDispatcher.h"
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <cstdint>
+
+class NotificationStore
+{
+public:
+	virtual ~NotificationStore() = default;
+
+	struct ReportedObservation
+	{
+		std::string observationId;
+		std::string observationDate;
+		uint64_t fingerprint = 0;// Zero if unknown (i.e. recorded by an older version)
+	};
+
+	// Appending a record for an observation that is already in the history supersedes the
+	// earlier record; reads return only the latest record for each observation
+	virtual bool Read(std::vector<ReportedObservation>& observations) = 0;
+	virtual bool Read(const std::unordered_set<std::string>& observationIds, std::vector<ReportedObservation>& observations) = 0;// Only the given observations
+	virtual bool Write(const std::vector<ReportedObservation>& observations) = 0;
+	virtual bool Append(const std::vector<ReportedObservation>& observations) = 0;
+
+	// Membership pre-filter kept alongside the history; returns false if there isn't a usable one.
+	// Write the filter after the history it describes.
+	virtual bool ReadFilter(BloomFilter& filter) = 0;
+	virtual bool WriteFilter(const BloomFilter& filter) = 0;
+
+	// Repeat-sighting events tracked across runs
+	virtual bool ReadEvents(std::vector<EventClusterer::Event>& events) = 0;
+	virtual bool WriteEvents(const std::vector<EventClusterer::Event>& events) = 0;
+
+	// Notifications that some transports have yet to deliver
+	virtual bool ReadPendingDeliveries(std::vector<NotificationDispatcher::Delivery>& deliveries) = 0;
+	virtual bool WritePendingDeliveries(const std::vector<NotificationDispatcher::Delivery>& deliveries) = 0;
+
+	// When each watch was last fetched [sec since epoch], keyed by watch
+	virtual bool ReadFetchTimes(std::unordered_map<std::string, int64_t>& times) = 0;
+	virtual bool WriteFetchTimes(const std::unordered_map<std::string, int64_t>& times) = 0;
+
+	// Coordination between workers sharing the store.  Locks and heartbeats are leases,
+	// so a worker that dies can only hold up the others until its lease expires.
+	virtual bool TryLock(const std::string& owner, const std::chrono::seconds& lease) = 0;
+	virtual void Unlock(const std::string& owner) = 0;
+	virtual bool Heartbeat(const std::string& worker) = 0;
+	virtual bool GetLiveWorkers(const std::chrono::seconds& lease, std::vector<std::string>& workers) = 0;
+};
+
+#endif// NOTIFICATION_STORE_H_
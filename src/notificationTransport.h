@@ -0,0 +1,33 @@
+// File:  notificationTransport.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Interface to a channel over which notifications are delivered (e-mail, webhook, file, etc.).
+
+#ifndef NOTIFICATION_TRANSPORT_H_
+#define NOTIFICATION_TRANSPORT_H_
+
+// Local headers
+#include "utilities/uString.h"
+
+// Standard C++ headers
+#include <string>
+
+class NotificationTransport
+{
+public:
+	virtual ~NotificationTransport() = default;
+
+	struct Message
+	{
+		std::string subject;
+		std::string htmlBody;
+		std::string textBody;
+	};
+
+	virtual std::string GetName() const = 0;
+
+	// Transports may be called concurrently with one another, so each is given its own log
+	virtual bool Send(const Message& message, UString::OStream& log) = 0;
+};
+
+#endif// NOTIFICATION_TRANSPORT_H_
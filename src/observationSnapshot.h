@@ -0,0 +1,23 @@
+// File:  observationSnapshot.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Immutable view of what was notable as of a particular poll.
+
+#ifndef OBSERVATION_SNAPSHOT_H_
+#define OBSERVATION_SNAPSHOT_H_
+
+// Local headers
+#include "eBirdInterface.h"
+
+// Standard C++ headers
+#include <vector>
+#include <chrono>
+
+struct ObservationSnapshot
+{
+	std::chrono::system_clock::time_point published;
+	unsigned int cycle;
+	std::vector<EBirdInterface::ObservationInfo> observations;// Deduplicated, with excluded species removed
+};
+
+#endif// OBSERVATION_SNAPSHOT_H_
@@ -0,0 +1,109 @@
+// File:  pollArena.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Monotonic arena for data that lives only as long as a single poll cycle.
+
+// Local headers
+#include "pollArena.h"
+#include "email/cJSON/cJSON.h"
+
+// Standard C++ headers
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+
+thread_local PollArena* PollArena::cJSONArena(nullptr);
+std::mutex PollArena::cJSONHookMutex;
+unsigned int PollArena::cJSONScopeCount(0);
+
+PollArena::PollArena(const size_t& initialSize) : buffer(initialSize)
+{
+	arena.emplace(buffer.data(), buffer.size(), &upstream);
+}
+
+PollArena::~PollArena()
+{
+	assert(cJSONArena != this && "arena destroyed while cJSON hooks still point to it");
+}
+
+void PollArena::Release()
+{
+	arena.reset();
+	if (upstream.overflowBytes > 0)
+	{
+		buffer.resize(buffer.size() + upstream.overflowBytes);
+		upstream.overflowBytes = 0;
+	}
+	arena.emplace(buffer.data(), buffer.size(), &upstream);
+}
+
+bool PollArena::Contains(const void* p) const
+{
+	// Comparing unrelated pointers with < isn't guaranteed to be meaningful, but std::less is
+	const auto within([p](const std::byte* start, const size_t& size)
+	{
+		const std::byte* b(static_cast<const std::byte*>(p));
+		return !std::less<const std::byte*>()(b, start) && std::less<const std::byte*>()(b, start + size);
+	});
+
+	// Overflow blocks grow geometrically, so there are only ever a few of them
+	return within(buffer.data(), buffer.size()) || std::any_of(upstream.blocks.begin(), upstream.blocks.end(),
+		[&within](const std::pair<const std::byte*, size_t>& block) { return within(block.first, block.second); });
+}
+
+void* PollArena::OverflowCounter::do_allocate(size_t bytes, size_t alignment)
+{
+	overflowBytes += bytes;
+	void* p(std::pmr::new_delete_resource()->allocate(bytes, alignment));
+	blocks.emplace_back(static_cast<const std::byte*>(p), bytes);
+	return p;
+}
+
+void PollArena::OverflowCounter::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+	blocks.erase(std::find(blocks.begin(), blocks.end(), std::make_pair(static_cast<const std::byte*>(p), bytes)));
+	std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+PollArena::CJSONScope::CJSONScope(PollArena* arena) : previous(cJSONArena), active(arena != nullptr)
+{
+	if (!active)
+		return;
+
+	cJSONArena = arena;
+	std::lock_guard<std::mutex> lock(cJSONHookMutex);
+	if (cJSONScopeCount++ > 0)
+		return;
+
+	cJSON_Hooks hooks;
+	hooks.malloc_fn = CJSONAllocate;
+	hooks.free_fn = CJSONFree;
+	cJSON_InitHooks(&hooks);
+}
+
+PollArena::CJSONScope::~CJSONScope()
+{
+	if (!active)
+		return;
+
+	cJSONArena = previous;
+	std::lock_guard<std::mutex> lock(cJSONHookMutex);
+	if (--cJSONScopeCount == 0)
+		cJSON_InitHooks(nullptr);// Restore malloc/free
+}
+
+void* PollArena::CJSONAllocate(size_t size)
+{
+	if (!cJSONArena)
+		return std::malloc(size);
+	return cJSONArena->Resource()->allocate(size, alignof(std::max_align_t));
+}
+
+// Blocks from before the hooks were installed, or from other threads, are ordinary malloc blocks
+void PollArena::CJSONFree(void* p)
+{
+	if (cJSONArena && cJSONArena->Contains(p))
+		return;// Reclaimed by Release()
+	std::free(p);
+}
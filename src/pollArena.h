@@ -0,0 +1,78 @@
+// File:  pollArena.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Monotonic arena for data that lives only as long as a single poll cycle.
+
+#ifndef POLL_ARENA_H_
+#define POLL_ARENA_H_
+
+// Standard C++ headers
+#include <memory_resource>
+#include <vector>
+#include <optional>
+#include <mutex>
+#include <utility>
+#include <cstddef>
+
+class PollArena
+{
+public:
+	explicit PollArena(const size_t& initialSize = 256 * 1024);
+	~PollArena();
+
+	PollArena(const PollArena&) = delete;
+	PollArena& operator=(const PollArena&) = delete;
+
+	std::pmr::memory_resource* Resource() { return &*arena; }
+
+	// Frees everything allocated since the last release in one step.  If the last cycle
+	// overflowed the arena's buffer, the buffer is grown so the next cycle fits.
+	void Release();
+
+	// While in scope, routes cJSON allocations made on this thread to the arena (freeing them
+	// is a no-op).  cJSON's hooks are global, so they are installed only while at least one
+	// scope is open, and then send allocations from other threads (or from this one, outside
+	// of any scope) to malloc/free.  Everything cJSON allocates in a scope must be freed or
+	// abandoned before the scope closes.
+	class CJSONScope
+	{
+	public:
+		explicit CJSONScope(PollArena* arena);
+		~CJSONScope();
+
+		CJSONScope(const CJSONScope&) = delete;
+		CJSONScope& operator=(const CJSONScope&) = delete;
+
+	private:
+		PollArena* const previous;
+		const bool active;
+	};
+
+private:
+	// Upstream for the monotonic resource; tracks how far past the buffer we spilled, and where
+	class OverflowCounter : public std::pmr::memory_resource
+	{
+	public:
+		size_t overflowBytes = 0;
+		std::vector<std::pair<const std::byte*, size_t>> blocks;// Currently allocated
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+	};
+
+	std::vector<std::byte> buffer;
+	OverflowCounter upstream;
+	std::optional<std::pmr::monotonic_buffer_resource> arena;
+
+	bool Contains(const void* p) const;// True if p was allocated from the arena
+
+	static thread_local PollArena* cJSONArena;
+	static std::mutex cJSONHookMutex;
+	static unsigned int cJSONScopeCount;// Open scopes on all threads
+	static void* CJSONAllocate(size_t size);
+	static void CJSONFree(void* p);
+};
+
+#endif// POLL_ARENA_H_
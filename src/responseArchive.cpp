@@ -0,0 +1,276 @@
+// File:  responseArchive.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Compressed archive of raw eBird responses (e.g. for replaying later).  Responses are
+//        stored as zlib streams with a preset dictionary of eBird's JSON vocabulary, which
+//        compresses small responses far better than starting from nothing.
+
+// Local headers
+#include "responseArchive.h"
+#include "compressedFile.h"
+
+// zlib headers
+#include <zlib.h>
+
+// Standard C++ headers
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <ctime>
+#include <cctype>
+
+const std::string ResponseArchive::extension(".json.z");
+
+// Text that commonly appears in recent/notable responses.  zlib gives the end of the dictionary the
+// shortest back-references, so the most common text comes last.
+const std::vector<std::string> ResponseArchive::dictionaries = {
+	// Version 1; no longer used for new archives, but needed to read those written with it
+	std::string(
+		"\"errors\":[{\"status\":\"400\",\"code\":\"\",\"title\":\"\"}]"
+		"\"countryCode\":\"CA\",\"countryName\":\"Canada\",\"subnational1Name\":\"Ontario\","
+		"\"evidence\":\"P\",\"evidence\":\"A\",\"evidence\":\"V\",\"obsTime\":\"\","
+		"\"howMany\":2,\"howMany\":3,\"presenceNoted\":true,\"obsValid\":true,\"obsReviewed\":true,"
+		"\"hasComments\":true,\"hasRichMedia\":true,\"locationPrivate\":true,"
+		"Goose\",\"sciName\":\"Anser Duck\",\"sciName\":\"Anas Gull\",\"sciName\":\"Larus Warbler\",\"sciName\":\"Setophaga "
+		"Sparrow\",\"sciName\":\"Hawk\",\"sciName\":\"Buteo Owl\",\"sciName\":\"Tern\",\"sciName\":\"Sandpiper\",\"sciName\":\"Calidris "
+		"\"countryCode\":\"US\",\"countryName\":\"United States\",\"userDisplayName\":\""
+		"{\"speciesCode\":\"\",\"comName\":\"\",\"sciName\":\"\",\"locId\":\"L\",\"locName\":\"\",\"obsDt\":\"20"
+		"\",\"howMany\":1,\"lat\":4\",\"lng\":-7,\"obsValid\":false,\"obsReviewed\":false,\"locationPrivate\":false,\"subId\":\"S"
+		"\",\"subnational2Code\":\"US-\",\"subnational2Name\":\"\",\"subnational1Code\":\"US-\",\"subnational1Name\":\""
+		"\",\"obsId\":\"OBS\",\"checklistId\":\"CL\",\"presenceNoted\":false,\"hasComments\":false,\"firstName\":\"\",\"lastName\":\""
+		"\",\"hasRichMedia\":false},{\"speciesCode\":\""),
+
+	// Version 2, in the form produced by --build-dictionary (see BuildDictionary()):  whole fields and field
+	// name prefixes, separated by commas.  Listed from the fields of a detail=full record, keeping only values
+	// that repeat between records (flags, counts, country); the next version should be built from a large
+	// archive of real responses with --build-dictionary and added after this one.
+	std::string(
+		"\"hasComments\":true,\"hasRichMedia\":true,\"presenceNoted\":true,\"obsReviewed\":true,\"obsValid\":true,"
+		"\"locationPrivate\":true,\"evidence\":\",\"howMany\":3,\"howMany\":2,\"howMany\":1,\"countryCode\":\"US\","
+		"\"countryName\":\"United States\",\"firstName\":\",\"lastName\":\",\"userDisplayName\":\",\"subnational2Name\":\","
+		"\"subnational1Name\":\",\"subnational2Code\":\",\"subnational1Code\":\",\"obsId\":\",\"checklistId\":\",\"subId\":\","
+		"\"locName\":\",\"locId\":\",\"obsDt\":\",\"lat\":,\"lng\":,\"howMany\":,\"sciName\":\",\"comName\":\",\"speciesCode\":\","
+		"\"locationPrivate\":false,\"obsReviewed\":false,\"obsValid\":false,\"presenceNoted\":false,\"hasComments\":false,"
+		"\"hasRichMedia\":false,")
+};
+
+bool ResponseArchive::Save(const std::string& name, const std::string& response)
+{
+	std::string compressed;
+	if (!Compress(response, compressed))
+	{
+		log << "Failed to compress response for archiving" << std::endl;
+		return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(directory, ec);
+
+	const std::time_t now(std::time(nullptr));
+	char timeStamp[32];
+	std::strftime(timeStamp, sizeof(timeStamp), "%Y%m%dT%H%M%SZ", std::gmtime(&now));
+	const auto fileName((std::filesystem::path(directory) / (std::string(timeStamp) + '_' + SanitizeName(name) + extension)).string());
+
+	// Written under a temporary name so nothing reading the archive sees a partial file
+	const std::string tempFileName(fileName + ".tmp");
+	{
+		std::ofstream file(tempFileName, std::ios::binary);
+		if (!file.is_open() || !file.write(compressed.data(), compressed.size()))
+		{
+			log << "Failed to write '" << UString::ToStringType(tempFileName) << "'" << std::endl;
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempFileName, fileName, ec);
+	if (ec)
+	{
+		log << "Failed to write '" << UString::ToStringType(fileName) << "'" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool ResponseArchive::Load(const std::string& fileName, std::string& response)
+{
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	// zlib header:  compression method in the low bits of the first byte, and a check that makes the pair a multiple of 31
+	unsigned char header[2] = {};
+	file.read(reinterpret_cast<char*>(header), sizeof(header));
+	if (file.gcount() != sizeof(header) || (header[0] & 0x0f) != Z_DEFLATED || (header[0] * 256 + header[1]) % 31 != 0)
+	{
+		file.close();
+		return CompressedFile::Read(fileName, response);// Saved some other way
+	}
+	file.seekg(0);
+
+	z_stream stream{};
+	if (inflateInit(&stream) != Z_OK)
+		return false;
+
+	constexpr uInt chunkSize(64 * 1024);
+	std::vector<unsigned char> in(chunkSize);
+	response.clear();
+	int result(Z_OK);
+	do
+	{
+		if (stream.avail_in == 0)
+		{
+			file.read(reinterpret_cast<char*>(in.data()), in.size());
+			stream.next_in = in.data();
+			stream.avail_in = static_cast<uInt>(file.gcount());
+			if (stream.avail_in == 0)
+				break;// Truncated
+		}
+
+		const size_t offset(response.size());
+		response.resize(offset + chunkSize);
+		stream.next_out = reinterpret_cast<Bytef*>(response.data() + offset);
+		stream.avail_out = chunkSize;
+		result = inflate(&stream, Z_NO_FLUSH);
+		if (result == Z_NEED_DICT)
+		{
+			const std::string* dictionary(FindDictionary(stream.adler));// Set to the dictionary's ID when one is needed
+			if (dictionary && inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary->data()), static_cast<uInt>(dictionary->size())) == Z_OK)
+				result = inflate(&stream, Z_NO_FLUSH);
+			else
+				result = Z_DATA_ERROR;
+		}
+		response.resize(offset + chunkSize - stream.avail_out);
+	} while (result == Z_OK || result == Z_BUF_ERROR);
+
+	inflateEnd(&stream);
+	return result == Z_STREAM_END;
+}
+
+bool ResponseArchive::Compress(const std::string& response, std::string& compressed)
+{
+	z_stream stream{};
+	if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+		return false;
+
+	const std::string& dictionary(dictionaries.back());
+	if (deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.data()), static_cast<uInt>(dictionary.size())) != Z_OK)
+	{
+		deflateEnd(&stream);
+		return false;
+	}
+
+	compressed.resize(deflateBound(&stream, static_cast<uLong>(response.size())));
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(response.data()));
+	stream.avail_in = static_cast<uInt>(response.size());
+	stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+	stream.avail_out = static_cast<uInt>(compressed.size());
+
+	const int result(deflate(&stream, Z_FINISH));
+	compressed.resize(stream.total_out);
+	deflateEnd(&stream);
+	return result == Z_STREAM_END;
+}
+
+const std::string* ResponseArchive::FindDictionary(const unsigned long& id)
+{
+	for (const auto& d : dictionaries)
+	{
+		if (adler32(adler32(0, nullptr, 0), reinterpret_cast<const Bytef*>(d.data()), static_cast<uInt>(d.size())) == id)
+			return &d;
+	}
+	return nullptr;
+}
+
+bool ResponseArchive::BuildDictionary(const std::string& directory, const size_t& maxSize, std::string& dictionary, UString::OStream& log)
+{
+	// Responses are compact JSON, so splitting before each name gives one fragment per field (e.g. "comName":"Canada Goose").
+	// Each field is counted whole and also up to the start of its value, which recurs even where the value doesn't.
+	std::unordered_map<std::string, size_t> counts;
+	unsigned int responseCount(0);
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::directory_iterator(directory, ec))
+	{
+		if (!entry.is_regular_file() || entry.path().extension() == ".tmp")
+			continue;
+
+		std::string response;
+		if (!Load(entry.path().string(), response))
+		{
+			log << "Failed to read '" << UString::ToStringType(entry.path().string()) << "'; skipping" << std::endl;
+			continue;
+		}
+		++responseCount;
+
+		// Records are flat objects, so a field ends at the next one or at the end of the record
+		for (size_t start(response.find('"')); start != std::string::npos;)
+		{
+			const size_t end(std::min(response.find(",\"", start), response.find('}', start)));
+			const std::string field(response.substr(start, end == std::string::npos ? std::string::npos : end - start));
+
+			const size_t valueStart(field.find("\":"));
+			if (valueStart != std::string::npos)
+			{
+				++counts[field];
+				const size_t prefixEnd(valueStart + 2 + (field.compare(valueStart + 2, 1, "\"") == 0 ? 1 : 0));
+				if (prefixEnd < field.size())
+					++counts[field.substr(0, prefixEnd)];
+			}
+
+			start = end == std::string::npos ? end : response.find('"', end);
+		}
+	}
+
+	if (ec)
+	{
+		log << "Failed to read '" << UString::ToStringType(directory) << "':  " << UString::ToStringType(ec.message()) << std::endl;
+		return false;
+	}
+
+	// Keep what saves the most (roughly, how often it occurs times its length), then order it so that the most
+	// common fragments are at the end, where zlib's back-references to them are shortest
+	std::vector<std::pair<std::string, size_t>> fragments;
+	for (auto& c : counts)
+	{
+		if (c.second > 1)
+			fragments.emplace_back(c.first, c.second);
+	}
+
+	// Ties are broken by the text, so that the same archive always gives the same dictionary
+	std::sort(fragments.begin(), fragments.end(), [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b)
+	{
+		const size_t scoreA(a.second * a.first.size()), scoreB(b.second * b.first.size());
+		return scoreA != scoreB ? scoreA > scoreB : a.first < b.first;
+	});
+
+	size_t size(0);
+	size_t keep(0);
+	while (keep < fragments.size() && size + fragments[keep].first.size() + 1 <= maxSize)
+		size += fragments[keep++].first.size() + 1;
+	fragments.resize(keep);
+
+	std::sort(fragments.begin(), fragments.end(), [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b)
+	{
+		return a.second != b.second ? a.second < b.second : a.first < b.first;
+	});
+
+	dictionary.clear();
+	for (const auto& f : fragments)
+		dictionary += f.first + ',';
+
+	log << "Built a " << dictionary.size() << " byte dictionary from " << responseCount << " responses" << std::endl;
+	return responseCount > 0;
+}
+
+std::string ResponseArchive::SanitizeName(const std::string& name)
+{
+	std::string sanitized(name);
+	for (auto& c : sanitized)
+	{
+		if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.')
+			c = '_';
+	}
+	return sanitized;
+}
@@ -0,0 +1,51 @@
+// File:  responseArchive.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Compressed archive of raw eBird responses (e.g. for replaying later).  Responses are
+//        stored as zlib streams with a preset dictionary of eBird's JSON vocabulary, which
+//        compresses small responses far better than starting from nothing.
+
+#ifndef RESPONSE_ARCHIVE_H_
+#define RESPONSE_ARCHIVE_H_
+
+// Local headers
+#include "utilities/uString.h"
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+
+class ResponseArchive
+{
+public:
+	ResponseArchive(const std::string& directory, UString::OStream& log) : directory(directory), log(log) {}
+
+	// Written to <directory>/<UTC time>_<name>.json.z
+	bool Save(const std::string& name, const std::string& response);
+
+	// Handles both archived and plain (uncompressed) responses; archived responses are
+	// decompressed as they're read, without holding the compressed file in memory
+	static bool Load(const std::string& fileName, std::string& response);
+
+	static const std::string extension;
+
+	// Builds a dictionary from the responses saved in directory (archived or plain):  the fields (name and value)
+	// and field name prefixes that recur across responses, least common first, up to maxSize bytes
+	static bool BuildDictionary(const std::string& directory, const size_t& maxSize, std::string& dictionary, UString::OStream& log);
+
+private:
+	const std::string directory;
+	UString::OStream& log;
+
+	// Each archive records the Adler-32 checksum of the dictionary it was compressed with (in the
+	// zlib header), which Load() uses to pick the same one.  So that older archives stay readable,
+	// don't edit a dictionary; add a new one to the end (the last is used for new archives).
+	static const std::vector<std::string> dictionaries;
+
+	static const std::string* FindDictionary(const unsigned long& id);
+
+	static bool Compress(const std::string& response, std::string& compressed);
+	static std::string SanitizeName(const std::string& name);
+};
+
+#endif// RESPONSE_ARCHIVE_H_
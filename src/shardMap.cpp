@@ -0,0 +1,37 @@
+// File:  shardMap.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Consistent hash ring for assigning watches to workers.
+
+// Local headers
+#include "shardMap.h"
+#include "fnv1a.h"
+
+// Standard C++ headers
+#include <algorithm>
+#include <cassert>
+
+ShardMap::ShardMap(const std::vector<std::string>& workers, const unsigned int& virtualNodes) : workers(workers)
+{
+	assert(!workers.empty() && virtualNodes > 0);
+	ring.reserve(workers.size() * virtualNodes);
+	for (unsigned int i = 0; i < workers.size(); ++i)
+	{
+		for (unsigned int j = 0; j < virtualNodes; ++j)
+			ring.emplace_back(Hash(workers[i] + '#' + std::to_string(j)), i);
+	}
+
+	std::sort(ring.begin(), ring.end());
+}
+
+const std::string& ShardMap::GetOwner(const std::string& key) const
+{
+	// First point at or after the key's hash, wrapping around to the start of the ring
+	const auto it(std::lower_bound(ring.begin(), ring.end(), std::make_pair(Hash(key), 0u)));
+	return workers[(it == ring.end() ? ring.front() : *it).second];
+}
+
+uint64_t ShardMap::Hash(const std::string& s)
+{
+	return FNV1a::Mix(FNV1a::Hash(s));
+}
@@ -0,0 +1,30 @@
+// File:  shardMap.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Consistent hash ring for assigning watches to workers.
+
+#ifndef SHARD_MAP_H_
+#define SHARD_MAP_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class ShardMap
+{
+public:
+	// Each worker is placed on the ring at several points to even out the load
+	explicit ShardMap(const std::vector<std::string>& workers, const unsigned int& virtualNodes = 64);
+
+	// Adding or removing a worker only moves the keys adjacent to its points on the ring
+	const std::string& GetOwner(const std::string& key) const;
+
+	static uint64_t Hash(const std::string& s);
+
+private:
+	std::vector<std::string> workers;
+	std::vector<std::pair<uint64_t, unsigned int>> ring;// Sorted by hash; second is index into workers
+};
+
+#endif// SHARD_MAP_H_
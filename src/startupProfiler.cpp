@@ -0,0 +1,87 @@
+// File:  startupProfiler.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Records when the application reaches key points after launch (e.g. the first
+//        network request), for measuring how much of a run is spent outside the network.
+
+// Local headers
+#include "startupProfiler.h"
+
+// Standard C++ headers
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+// *nix headers
+#include <time.h>
+#include <unistd.h>
+#endif// _WIN32
+
+bool StartupProfiler::enabled(false);
+StartupProfiler::Clock::time_point StartupProfiler::start;
+std::vector<std::pair<std::string, StartupProfiler::Clock::time_point>> StartupProfiler::marks;
+
+void StartupProfiler::Enable()
+{
+	enabled = true;
+	start = GetLaunchTime();
+	marks.clear();
+}
+
+// So that loading and static initialization (which happen before we can enable the profiler) are counted
+StartupProfiler::Clock::time_point StartupProfiler::GetLaunchTime()
+{
+	const auto now(Clock::now());
+#ifdef _WIN32
+	return now;
+#else
+	// Field 22 of /proc/self/stat is the start time in clock ticks since boot.  The command name
+	// (field 2) is in parentheses and may contain spaces, so start counting after it.
+	std::ifstream file("/proc/self/stat");
+	std::string stat;
+	timespec sinceBoot;
+	if (!std::getline(file, stat) || clock_gettime(CLOCK_BOOTTIME, &sinceBoot) != 0)
+		return now;
+
+	const auto commandEnd(stat.rfind(')'));
+	if (commandEnd == std::string::npos)
+		return now;
+
+	std::istringstream fields(stat.substr(commandEnd + 1));
+	std::string field;
+	for (unsigned int i = 3; i < 22; ++i)
+		fields >> field;
+
+	unsigned long long startTicks;
+	const long ticksPerSecond(sysconf(_SC_CLK_TCK));
+	if (!(fields >> startTicks) || ticksPerSecond <= 0)
+		return now;
+
+	const auto launchedSinceBoot(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(static_cast<double>(startTicks) / ticksPerSecond)));
+	const auto nowSinceBoot(std::chrono::seconds(sinceBoot.tv_sec) + std::chrono::nanoseconds(sinceBoot.tv_nsec));
+	return now - std::chrono::duration_cast<Clock::duration>(nowSinceBoot - launchedSinceBoot);
+#endif// _WIN32
+}
+
+void StartupProfiler::Mark(const std::string& stage)
+{
+	if (!enabled)
+		return;
+
+	if (std::find_if(marks.begin(), marks.end(), [&stage](const auto& m) { return m.first == stage; }) != marks.end())
+		return;
+
+	marks.emplace_back(stage, Clock::now());
+}
+
+void StartupProfiler::Report(UString::OStream& log)
+{
+	if (!enabled)
+		return;
+
+	log << "Startup profile [ms since launch]:" << std::endl;
+	for (const auto& m : marks)
+		log << "  " << UString::ToStringType(m.first) << ":  " << std::chrono::duration_cast<std::chrono::microseconds>(m.second - start).count() / 1000.0 << std::endl;
+}
@@ -0,0 +1,40 @@
+// File:  startupProfiler.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Records when the application reaches key points after launch (e.g. the first
+//        network request), for measuring how much of a run is spent outside the network.
+
+#ifndef STARTUP_PROFILER_H_
+#define STARTUP_PROFILER_H_
+
+// Local headers
+#include "utilities/uString.h"
+
+// Standard C++ headers
+#include <chrono>
+#include <vector>
+#include <string>
+
+class StartupProfiler
+{
+public:
+	// Marks are ignored unless the profiler is enabled
+	static void Enable();
+	static void Disable() { enabled = false; }
+	static bool IsEnabled() { return enabled; }
+
+	// Only the first mark with a given name is recorded
+	static void Mark(const std::string& stage);
+	static void Report(UString::OStream& log);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	static bool enabled;
+	static Clock::time_point start;
+	static std::vector<std::pair<std::string, Clock::time_point>> marks;
+
+	static Clock::time_point GetLaunchTime();
+};
+
+#endif// STARTUP_PROFILER_H_
@@ -0,0 +1,251 @@
+// File:  statusServer.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Answers local status queries over a Unix domain socket with the most recently
+//        published observation snapshot (as JSON).  Runs on its own thread and only ever
+//        reads published snapshots, so clients can't hold up the poll loop.
+
+// Local headers
+#include "statusServer.h"
+
+// Standard C++ headers
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <ctime>
+
+#ifndef _WIN32
+// *nix headers
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif// _WIN32
+
+StatusServer::~StatusServer()
+{
+	Stop();
+}
+
+#ifdef _WIN32
+
+bool StatusServer::Start(const std::string& /*socketPath*/)
+{
+	log << "Status socket is not supported on this platform" << std::endl;
+	return false;
+}
+
+void StatusServer::Stop()
+{
+}
+
+#else
+
+bool StatusServer::Start(const std::string& path)
+{
+	sockaddr_un address{};
+	if (path.size() >= sizeof(address.sun_path))
+	{
+		log << "Status socket path '" << UString::ToStringType(path) << "' is too long" << std::endl;
+		return false;
+	}
+
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+	// A socket may have been left behind if we didn't exit cleanly last time, but don't remove anything else
+	struct stat existing;
+	if (lstat(path.c_str(), &existing) == 0)
+	{
+		if (!S_ISSOCK(existing.st_mode))
+		{
+			log << "Status socket path '" << UString::ToStringType(path) << "' exists and is not a socket" << std::endl;
+			return false;
+		}
+		std::remove(path.c_str());
+	}
+
+	listenFD = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listenFD < 0 ||
+		bind(listenFD, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+		listen(listenFD, 8) != 0 ||
+		pipe(stopFD) != 0)
+	{
+		log << "Failed to open status socket '" << UString::ToStringType(path) << "':  " << std::strerror(errno) << std::endl;
+		Stop();
+		return false;
+	}
+
+	socketPath = path;
+	thread = std::thread(&StatusServer::Serve, this);
+	return true;
+}
+
+void StatusServer::Stop()
+{
+	if (thread.joinable())
+	{
+		const char c(0);
+		if (write(stopFD[1], &c, 1) != 1)
+			log << "Failed to signal status server to stop" << std::endl;
+		thread.join();
+	}
+
+	for (auto fd : { listenFD, stopFD[0], stopFD[1] })
+	{
+		if (fd >= 0)
+			close(fd);
+	}
+	listenFD = stopFD[0] = stopFD[1] = -1;
+
+	if (!socketPath.empty())
+	{
+		std::remove(socketPath.c_str());
+		socketPath.clear();
+	}
+}
+
+void StatusServer::Serve()
+{
+	while (true)
+	{
+		pollfd fds[2] = { { listenFD, POLLIN, 0 }, { stopFD[0], POLLIN, 0 } };
+		if (poll(fds, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+
+		if (fds[1].revents != 0)
+			return;
+
+		if ((fds[0].revents & POLLIN) == 0)
+			continue;
+
+		const int clientFD(accept4(listenFD, nullptr, nullptr, SOCK_CLOEXEC));
+		if (clientFD < 0)
+			continue;
+
+		Respond(clientFD);
+		close(clientFD);
+	}
+}
+
+void StatusServer::Respond(const int& clientFD)
+{
+	// Give a client that's going to send a request a moment to do so, but don't wait on one that isn't
+	char request[1024];
+	ssize_t requestSize(0);
+	pollfd fd{ clientFD, POLLIN, 0 };
+	if (poll(&fd, 1, 100) > 0)
+		requestSize = read(clientFD, request, sizeof(request));
+
+	const auto snapshot(source());
+	const std::string body(BuildResponseBody(snapshot.get()));
+	std::string response;
+	if (requestSize >= 4 && std::strncmp(request, "GET ", 4) == 0)
+		response = "HTTP/1.0 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+	response.append(body);
+
+	// A client that stops reading would otherwise block us (and every client after it) indefinitely
+	const timeval sendTimeout{ 2, 0 };
+	setsockopt(clientFD, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+	for (size_t written = 0; written < response.size();)
+	{
+		const ssize_t n(send(clientFD, response.data() + written, response.size() - written, MSG_NOSIGNAL));
+		if (n <= 0)
+			return;// Client went away or stopped reading; nothing to do about it
+		written += n;
+	}
+}
+
+#endif// _WIN32
+
+std::string StatusServer::BuildResponseBody(const ObservationSnapshot* snapshot)
+{
+	if (!snapshot)
+		return "{\"cycle\":0,\"observations\":[]}\n";
+
+	std::ostringstream ss;
+	const std::time_t published(std::chrono::system_clock::to_time_t(snapshot->published));
+	ss << "{\"published\":" << published << ",\"cycle\":" << snapshot->cycle << ",\"observations\":[";
+
+	std::string out(ss.str());
+	for (size_t i = 0; i < snapshot->observations.size(); ++i)
+	{
+		const auto& o(snapshot->observations[i]);
+		out.append(i == 0 ? "{" : ",{");
+		out.append("\"observationID\":");
+		WriteJSONString(out, UString::ToNarrowString(o.observationID));
+		out.append(",\"speciesCode\":");
+		WriteJSONString(out, UString::ToNarrowString(o.speciesCode));
+		out.append(",\"commonName\":");
+		WriteJSONString(out, UString::ToNarrowString(o.commonName));
+		out.append(",\"count\":");
+		out.append(o.presenceNoted ? "null" : std::to_string(o.count));
+		out.append(",\"locationName\":");
+		WriteJSONString(out, UString::ToNarrowString(o.locationName));
+
+		std::ostringstream position;
+		position << std::fixed << std::setprecision(6) << ",\"latitude\":" << o.latitude << ",\"longitude\":" << o.longitude;
+		out.append(position.str());
+
+		char date[32];
+		std::strftime(date, sizeof(date), o.dateIncludesTimeInfo ? "%Y-%m-%d %H:%M" : "%Y-%m-%d", &o.observationDate);
+		out.append(",\"date\":");
+		WriteJSONString(out, date);
+		out.append(",\"checklistID\":");
+		WriteJSONString(out, UString::ToNarrowString(o.checklistID));
+		out.append("}");
+	}
+
+	out.append("]}\n");
+	return out;
+}
+
+void StatusServer::WriteJSONString(std::string& out, const std::string& s)
+{
+	out.push_back('"');
+	for (const auto& c : s)
+	{
+		switch (c)
+		{
+		case '"':
+			out.append("\\\"");
+			break;
+
+		case '\\':
+			out.append("\\\\");
+			break;
+
+		case '\n':
+			out.append("\\n");
+			break;
+
+		case '\r':
+			out.append("\\r");
+			break;
+
+		case '\t':
+			out.append("\\t");
+			break;
+
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char escaped[8];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+				out.append(escaped);
+			}
+			else
+				out.push_back(c);
+		}
+	}
+	out.push_back('"');
+}
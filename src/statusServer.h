@@ -0,0 +1,55 @@
+// File:  statusServer.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Answers local status queries over a Unix domain socket with the most recently
+//        published observation snapshot (as JSON).  Runs on its own thread and only ever
+//        reads published snapshots, so clients can't hold up the poll loop.
+
+#ifndef STATUS_SERVER_H_
+#define STATUS_SERVER_H_
+
+// Local headers
+#include "observationSnapshot.h"
+#include "utilities/uString.h"
+
+// Standard C++ headers
+#include <functional>
+#include <memory>
+#include <thread>
+#include <string>
+
+class StatusServer
+{
+public:
+	typedef std::function<std::shared_ptr<const ObservationSnapshot>()> SnapshotSource;
+
+	StatusServer(const SnapshotSource& source, UString::OStream& log) : source(source), log(log) {}
+	~StatusServer();
+
+	StatusServer(const StatusServer&) = delete;
+	StatusServer& operator=(const StatusServer&) = delete;
+
+	// Clients may send an HTTP request (e.g. curl --unix-socket) or nothing at all (e.g. nc -U)
+	bool Start(const std::string& socketPath);
+	void Stop();
+
+	static std::string BuildResponseBody(const ObservationSnapshot* snapshot);
+
+private:
+	const SnapshotSource source;
+	UString::OStream& log;
+
+	std::string socketPath;
+	std::thread thread;
+#ifndef _WIN32
+	int listenFD = -1;
+	int stopFD[2] = { -1, -1 };// Written to wake the server thread when stopping
+
+	void Serve();
+	void Respond(const int& clientFD);
+#endif// _WIN32
+
+	static void WriteJSONString(std::string& out, const std::string& s);
+};
+
+#endif// STATUS_SERVER_H_
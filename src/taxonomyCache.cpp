@@ -0,0 +1,282 @@
+// File:  taxonomyCache.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Local, memory-mapped copy of the eBird taxonomy with a species code index.
+
+// Local headers
+#include "taxonomyCache.h"
+#include "fnv1a.h"
+
+// Standard C++ headers
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+// *nix headers
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif// _WIN32
+
+const char TaxonomyCache::fileMagic[4] = { 'E', 'B', 'T', 'X' };
+
+TaxonomyCache::~TaxonomyCache()
+{
+	Unmap();
+}
+
+bool TaxonomyCache::Load(const std::string& fileName, const unsigned int& maxAgeDays, EBirdInterface& ebi)
+{
+	Unmap();
+	if (IsStale(fileName, maxAgeDays))
+	{
+		log << "Refreshing taxonomy cache..." << std::endl;
+		if (!Refresh(fileName, ebi))
+			log << "Failed to refresh taxonomy; attempting to use existing cache" << std::endl;
+	}
+
+	return Map(fileName);
+}
+
+bool TaxonomyCache::IsStale(const std::string& fileName, const unsigned int& maxAgeDays)
+{
+	if (!Map(fileName))
+		return true;
+
+	const auto age(std::chrono::system_clock::now() - std::chrono::system_clock::from_time_t(static_cast<std::time_t>(header->fetchTime)));
+	Unmap();
+	return age > std::chrono::hours(24 * maxAgeDays);
+}
+
+bool TaxonomyCache::Refresh(const std::string& fileName, EBirdInterface& ebi)
+{
+	std::vector<EBirdInterface::TaxonomyInfo> taxonomy;
+	if (!ebi.GetTaxonomy(taxonomy))
+		return false;
+
+	// Write to a temporary file first so an interrupted write never leaves a corrupt cache behind
+	const std::string tempFileName(fileName + ".tmp");
+	if (!Write(tempFileName, taxonomy))
+	{
+		log << "Failed to write taxonomy cache to '" << UString::ToStringType(tempFileName) << "'" << std::endl;
+		return false;
+	}
+
+	std::remove(fileName.c_str());
+	if (std::rename(tempFileName.c_str(), fileName.c_str()) != 0)
+	{
+		log << "Failed to rename '" << UString::ToStringType(tempFileName) << "'" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool TaxonomyCache::Write(const std::string& fileName, const std::vector<EBirdInterface::TaxonomyInfo>& taxonomy)
+{
+	std::vector<EBirdInterface::TaxonomyInfo> sorted(taxonomy);
+	std::sort(sorted.begin(), sorted.end(), [](const EBirdInterface::TaxonomyInfo& a, const EBirdInterface::TaxonomyInfo& b)
+	{
+		return a.taxonOrder < b.taxonOrder;
+	});
+
+	std::string stringTable;
+	auto addString([&stringTable](const UString::String& s)
+	{
+		const auto offset(static_cast<uint32_t>(stringTable.size()));
+		stringTable.append(UString::ToNarrowString(s));
+		stringTable.push_back('\0');
+		return offset;
+	});
+
+	Header h{};
+	std::memcpy(h.magic, fileMagic, sizeof(h.magic));
+	h.version = fileVersion;
+	h.fetchTime = static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+	h.recordCount = static_cast<uint32_t>(sorted.size());
+	h.bucketCount = 1;
+	while (h.bucketCount < 2 * h.recordCount)// Keep load factor at or below 0.5
+		h.bucketCount <<= 1;
+
+	std::vector<Record> recordList(sorted.size());
+	std::vector<uint32_t> bucketList(h.bucketCount, emptyBucket);
+	for (uint32_t i = 0; i < recordList.size(); ++i)
+	{
+		const auto& t(sorted[i]);
+		auto& r(recordList[i]);
+		r.speciesCode = addString(t.speciesCode);
+		r.commonName = addString(t.commonName);
+		r.scientificName = addString(t.scientificName);
+		r.familyCode = addString(t.familyCode);
+		r.familyCommonName = addString(t.familyCommonName);
+		r.familyScientificName = addString(t.familyScientificName);
+		r.order = addString(t.order);
+		r.reserved = 0;
+		r.taxonOrder = t.taxonOrder;
+
+		uint32_t bucket(Hash(UString::ToNarrowString(t.speciesCode)) & (h.bucketCount - 1));
+		while (bucketList[bucket] != emptyBucket)
+			bucket = (bucket + 1) & (h.bucketCount - 1);
+		bucketList[bucket] = i;
+	}
+
+	h.stringTableSize = static_cast<uint32_t>(stringTable.size());
+
+	std::ofstream file(fileName, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	file.write(reinterpret_cast<const char*>(recordList.data()), recordList.size() * sizeof(Record));
+	file.write(reinterpret_cast<const char*>(bucketList.data()), bucketList.size() * sizeof(uint32_t));
+	file.write(stringTable.data(), stringTable.size());
+	return file.good();
+}
+
+bool TaxonomyCache::Map(const std::string& fileName)
+{
+#ifdef _WIN32
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.is_open())
+		return false;
+	buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	data = buffer.data();
+	dataSize = buffer.size();
+#else
+	const int fd(open(fileName.c_str(), O_RDONLY));
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header)))
+	{
+		close(fd);
+		return false;
+	}
+
+	void* mapped(mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+	close(fd);
+	if (mapped == MAP_FAILED)
+		return false;
+
+	data = static_cast<const char*>(mapped);
+	dataSize = info.st_size;
+#endif// _WIN32
+
+	if (dataSize < sizeof(Header))
+	{
+		Unmap();
+		return false;
+	}
+
+	header = reinterpret_cast<const Header*>(data);
+	const size_t recordsSize(static_cast<size_t>(header->recordCount) * sizeof(Record));
+	const size_t bucketsSize(static_cast<size_t>(header->bucketCount) * sizeof(uint32_t));
+	if (std::memcmp(header->magic, fileMagic, sizeof(header->magic)) != 0 ||
+		header->version != fileVersion ||
+		header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0 ||
+		dataSize != sizeof(Header) + recordsSize + bucketsSize + header->stringTableSize ||
+		(header->stringTableSize > 0 && data[dataSize - 1] != '\0'))// Empty for an empty taxonomy
+	{
+		log << "Taxonomy cache '" << UString::ToStringType(fileName) << "' is invalid" << std::endl;
+		Unmap();
+		return false;
+	}
+
+	records = reinterpret_cast<const Record*>(data + sizeof(Header));
+	buckets = reinterpret_cast<const uint32_t*>(data + sizeof(Header) + recordsSize);
+	strings = data + sizeof(Header) + recordsSize + bucketsSize;
+	if (!IndexIsValid())
+	{
+		log << "Taxonomy cache '" << UString::ToStringType(fileName) << "' is corrupt" << std::endl;
+		Unmap();
+		return false;
+	}
+
+	return true;
+}
+
+// Everything Find() follows must stay within the file:  buckets must refer to records, records to strings
+// (which are terminated, since the table ends with '\0'), and at least one bucket must be empty to end a probe
+bool TaxonomyCache::IndexIsValid() const
+{
+	uint32_t usedBuckets(0);
+	for (uint32_t i = 0; i < header->bucketCount; ++i)
+	{
+		if (buckets[i] == emptyBucket)
+			continue;
+		if (buckets[i] >= header->recordCount)
+			return false;
+		++usedBuckets;
+	}
+
+	if (usedBuckets != header->recordCount || usedBuckets >= header->bucketCount)
+		return false;
+
+	for (uint32_t i = 0; i < header->recordCount; ++i)
+	{
+		const Record& r(records[i]);
+		for (const auto& offset : { r.speciesCode, r.commonName, r.scientificName, r.familyCode, r.familyCommonName, r.familyScientificName, r.order })
+		{
+			if (offset >= header->stringTableSize)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void TaxonomyCache::Unmap()
+{
+#ifdef _WIN32
+	buffer.clear();
+#else
+	if (data)
+		munmap(const_cast<char*>(data), dataSize);
+#endif// _WIN32
+
+	data = nullptr;
+	dataSize = 0;
+	header = nullptr;
+	records = nullptr;
+	buckets = nullptr;
+	strings = nullptr;
+}
+
+bool TaxonomyCache::Find(const std::string_view& speciesCode, Taxon& taxon) const
+{
+	if (!data)
+		return false;
+
+	const uint32_t mask(header->bucketCount - 1);
+	for (uint32_t bucket = Hash(speciesCode) & mask; buckets[bucket] != emptyBucket; bucket = (bucket + 1) & mask)
+	{
+		const Record& r(records[buckets[bucket]]);
+		if (GetString(r.speciesCode) != speciesCode)
+			continue;
+
+		taxon.speciesCode = GetString(r.speciesCode);
+		taxon.commonName = GetString(r.commonName);
+		taxon.scientificName = GetString(r.scientificName);
+		taxon.familyCode = GetString(r.familyCode);
+		taxon.familyCommonName = GetString(r.familyCommonName);
+		taxon.familyScientificName = GetString(r.familyScientificName);
+		taxon.order = GetString(r.order);
+		taxon.taxonOrder = r.taxonOrder;
+		return true;
+	}
+
+	return false;
+}
+
+// Only the low bits are used, so they need to depend on the whole key
+uint32_t TaxonomyCache::Hash(const std::string_view& s)
+{
+	return static_cast<uint32_t>(FNV1a::Mix(FNV1a::Hash(s)));
+}
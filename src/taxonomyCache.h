@@ -0,0 +1,102 @@
+// File:  taxonomyCache.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Local, memory-mapped copy of the eBird taxonomy with a species code index.
+
+#ifndef TAXONOMY_CACHE_H_
+#define TAXONOMY_CACHE_H_
+
+// Local headers
+#include "eBirdInterface.h"
+
+// Standard C++ headers
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+class TaxonomyCache
+{
+public:
+	explicit TaxonomyCache(UString::OStream& log = Cout) : log(log) {}
+	~TaxonomyCache();
+
+	TaxonomyCache(const TaxonomyCache&) = delete;
+	TaxonomyCache& operator=(const TaxonomyCache&) = delete;
+
+	// Maps the cache file, first rebuilding it from eBird if it is missing or older than maxAgeDays.
+	// A stale file is still used if the refresh fails.
+	bool Load(const std::string& fileName, const unsigned int& maxAgeDays, EBirdInterface& ebi);
+	bool IsLoaded() const { return data != nullptr; }
+
+	struct Taxon
+	{
+		std::string_view speciesCode;
+		std::string_view commonName;
+		std::string_view scientificName;
+		std::string_view familyCode;
+		std::string_view familyCommonName;
+		std::string_view familyScientificName;
+		std::string_view order;
+		double taxonOrder;
+	};
+
+	bool Find(const std::string_view& speciesCode, Taxon& taxon) const;
+
+	static bool Write(const std::string& fileName, const std::vector<EBirdInterface::TaxonomyInfo>& taxonomy);
+
+private:
+	UString::OStream& log;
+
+	// File layout:  Header, Record[recordCount], uint32_t buckets[bucketCount], string table.
+	// Records are stored in taxonomic order and buckets form an open-addressed index keyed on species code.
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		int64_t fetchTime;
+		uint32_t recordCount;
+		uint32_t bucketCount;// Power of two
+		uint32_t stringTableSize;
+		uint32_t reserved;
+	};
+
+	struct Record
+	{
+		uint32_t speciesCode;// Offsets into string table
+		uint32_t commonName;
+		uint32_t scientificName;
+		uint32_t familyCode;
+		uint32_t familyCommonName;
+		uint32_t familyScientificName;
+		uint32_t order;
+		uint32_t reserved;
+		double taxonOrder;
+	};
+
+	static const char fileMagic[4];
+	static constexpr uint32_t fileVersion = 2;
+	static constexpr uint32_t emptyBucket = UINT32_MAX;
+
+	const char* data = nullptr;
+	size_t dataSize = 0;
+#ifdef _WIN32
+	std::vector<char> buffer;
+#endif// _WIN32
+
+	const Header* header = nullptr;
+	const Record* records = nullptr;
+	const uint32_t* buckets = nullptr;
+	const char* strings = nullptr;
+
+	bool Map(const std::string& fileName);
+	bool IndexIsValid() const;
+	void Unmap();
+	bool IsStale(const std::string& fileName, const unsigned int& maxAgeDays);
+	bool Refresh(const std::string& fileName, EBirdInterface& ebi);
+
+	std::string_view GetString(const uint32_t& offset) const { return std::string_view(strings + offset); }
+	static uint32_t Hash(const std::string_view& s);
+};
+
+#endif// TAXONOMY_CACHE_H_
@@ -0,0 +1,57 @@
+// File:  webhookTransport.cpp
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification transport that POSTs a JSON payload to a URL.
+
+// Local headers
+#include "webhookTransport.h"
+#include "email/cJSON/cJSON.h"
+
+bool WebhookTransport::Send(const Message& message, UString::OStream& log)
+{
+	AsyncCurl loop(log);
+	if (!caCertificatePath.empty())
+		loop.SetCACertificatePath(UString::ToStringType(caCertificatePath));
+
+	auto task(Post(loop, url, BuildPayload(message), log));
+	task.Start();
+	if (!loop.Run())
+		return false;
+
+	return task.IsDone() && task.Result();
+}
+
+std::string WebhookTransport::BuildPayload(const Message& message)
+{
+	cJSON* root(cJSON_CreateObject());
+	cJSON_AddStringToObject(root, "subject", message.subject.c_str());
+	cJSON_AddStringToObject(root, "text", message.textBody.c_str());
+	cJSON_AddStringToObject(root, "html", message.htmlBody.c_str());
+
+	char* text(cJSON_PrintUnformatted(root));
+	const std::string payload(text ? text : "");
+	cJSON_free(text);
+	cJSON_Delete(root);
+	return payload;
+}
+
+Task<bool> WebhookTransport::Post(AsyncCurl& loop, const std::string url, const std::string payload, UString::OStream& log)
+{
+	curl_slist* headers(curl_slist_append(nullptr, "Content-Type: application/json"));
+	const auto response(co_await loop.Post(UString::ToStringType(url), payload, [headers](CURL* curl)
+	{
+		return curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers) == CURLE_OK;
+	}));
+	curl_slist_free_all(headers);
+
+	if (!response.ok)
+		co_return false;
+
+	if (response.httpCode < 200 || response.httpCode >= 300)
+	{
+		log << "Webhook returned HTTP " << response.httpCode << ":  " << UString::ToStringType(response.body) << std::endl;
+		co_return false;
+	}
+
+	co_return true;
+}
@@ -0,0 +1,30 @@
+// File:  webhookTransport.h
+// Date:  10/18/2026
+// Auth:  K. Loux
+// Desc:  Notification transport that POSTs a JSON payload to a URL.
+
+#ifndef WEBHOOK_TRANSPORT_H_
+#define WEBHOOK_TRANSPORT_H_
+
+// Local headers
+#include "notificationTransport.h"
+#include "asyncCurl.h"
+
+class WebhookTransport : public NotificationTransport
+{
+public:
+	// Payload is {"subject":..., "text":..., "html":...}
+	WebhookTransport(const std::string& url, const std::string& caCertificatePath) : url(url), caCertificatePath(caCertificatePath) {}
+
+	std::string GetName() const override { return "webhook " + url; }
+	bool Send(const Message& message, UString::OStream& log) override;
+
+private:
+	const std::string url;
+	const std::string caCertificatePath;
+
+	static std::string BuildPayload(const Message& message);
+	static Task<bool> Post(AsyncCurl& loop, const std::string url, const std::string payload, UString::OStream& log);
+};
+
+#endif// WEBHOOK_TRANSPORT_H_